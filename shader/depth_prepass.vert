@@ -0,0 +1,29 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform vec2 jitter;
+
+#ifdef VERTEX_COMPRESSED
+uniform vec3 positionScale;
+uniform vec3 positionOffset;
+#endif
+
+// must match gbuffer.vert bit for bit, the gbuffer pass tests with GL_EQUAL
+invariant gl_Position;
+
+void main()
+{
+#ifdef VERTEX_COMPRESSED
+    vec3 position = aPos * positionScale + positionOffset;
+#else
+    vec3 position = aPos;
+#endif
+
+    vec4 worldPos = model * vec4(position, 1.0);
+    vec4 clipPos  = projection * view * worldPos;
+
+    gl_Position = clipPos + vec4(jitter * clipPos.w, 0.0, 0.0);
+}
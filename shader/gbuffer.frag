@@ -6,6 +6,7 @@ layout(location = 2) out vec4 gMotionShadingModel;
 
 in vec3 FragPos;
 in vec3 Normal;
+in vec3 Tangent;
 in vec2 TexCoord;
 in vec4 PrevClipPos;
 in vec4 CurrClipPos;
@@ -19,6 +20,18 @@ uniform float metallic     = 0.0;
 uniform float roughness    = 0.5;
 uniform int   shadingModel = 0;
 
+#ifdef GBUFFER_COMPACT
+// octahedral normal encoding, unit vector -> [0, 1]^2
+vec2 octWrap(vec2 v) { return (1.0 - abs(v.yx)) * vec2(v.x >= 0.0 ? 1.0 : -1.0, v.y >= 0.0 ? 1.0 : -1.0); }
+
+vec2 encodeOctahedral(vec3 n)
+{
+    n /= (abs(n.x) + abs(n.y) + abs(n.z));
+    n.xy = n.z >= 0.0 ? n.xy : octWrap(n.xy);
+    return n.xy * 0.5 + 0.5;
+}
+#endif
+
 vec2 calculateMotionVector()
 {
     vec2 currNDC = (CurrClipPos.xy / CurrClipPos.w) * 0.5 + 0.5;
@@ -30,13 +43,16 @@ vec3 getNormalFromMap()
 {
     vec3 tangentNormal = texture(texture_normal1, TexCoord).xyz * 2.0 - 1.0;
 
+    // derivatives outside of any branch, only used when the mesh has no tangents
     vec3 Q1  = dFdx(FragPos);
     vec3 Q2  = dFdy(FragPos);
     vec2 st1 = dFdx(TexCoord);
     vec2 st2 = dFdy(TexCoord);
 
-    vec3 N   = normalize(Normal);
-    vec3 T   = normalize(Q1 * st2.t - Q2 * st1.t);
+    vec3 N = normalize(Normal);
+    // mesh tangent, re-orthogonalized after interpolation
+    vec3 T = dot(Tangent, Tangent) > 1e-6 ? normalize(Tangent - N * dot(N, Tangent))
+                                          : normalize(Q1 * st2.t - Q2 * st1.t);
     vec3 B   = -normalize(cross(N, T));
     mat3 TBN = mat3(T, B, N);
 
@@ -52,7 +68,13 @@ void main()
     vec3 normal       = getNormalFromMap();
     vec2 motionVector = calculateMotionVector();
 
-    gAlbedoMetallic     = vec4(albedo, metallicValue);
+    gAlbedoMetallic = vec4(albedo, metallicValue);
+#ifdef GBUFFER_COMPACT
+    // RGB10A2: RG octahedral normal, B roughness, A shading model (2 bits); motion target is RG16F
+    gNormalRoughness    = vec4(encodeOctahedral(normal), roughnessValue, float(shadingModel) / 3.0);
+    gMotionShadingModel = vec4(motionVector, 0.0, 0.0);
+#else
     gNormalRoughness    = vec4(normal * 0.5 + 0.5, roughnessValue);
     gMotionShadingModel = vec4(motionVector, float(shadingModel) / 255.0, 1.0);
+#endif
 }
\ No newline at end of file
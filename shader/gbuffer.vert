@@ -1,10 +1,17 @@
 #version 330 core
 layout(location = 0) in vec3 aPos;
+#ifdef VERTEX_COMPRESSED
+layout(location = 1) in vec4 aNormalTangent; // snorm8 octahedral normal (xy) and tangent (zw)
+layout(location = 3) in uint aVertexFlags;
+#else
 layout(location = 1) in vec3 aNormal;
+layout(location = 3) in vec3 aTangent;
+#endif
 layout(location = 2) in vec2 aTexCoord;
 
 out vec3 FragPos;
 out vec3 Normal;
+out vec3 Tangent;
 out vec2 TexCoord;
 out vec4 PrevClipPos;
 out vec4 CurrClipPos;
@@ -13,16 +20,53 @@ uniform mat4 model;
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat4 prevMVP;
+uniform vec2 jitter; // sub-pixel TAA jitter, NDC
+
+#ifdef VERTEX_COMPRESSED
+// unorm16 position -> mesh space, per mesh
+uniform vec3 positionScale;
+uniform vec3 positionOffset;
+
+// aVertexFlags, matches g_vertex_has_tangent
+const uint VERTEX_HAS_TANGENT = 1u;
+
+vec3 decodeOctahedral(vec2 f)
+{
+    vec3  n = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+#endif
+
+// must match depth_prepass.vert bit for bit
+invariant gl_Position;
 
 void main()
 {
-    vec4 worldPos = model * vec4(aPos, 1.0);
+#ifdef VERTEX_COMPRESSED
+    vec3 position = aPos * positionScale + positionOffset;
+    vec3 normal   = decodeOctahedral(aNormalTangent.xy);
+    // zero tangent tells the fragment shader to fall back to derivatives
+    vec3 tangent  = (aVertexFlags & VERTEX_HAS_TANGENT) != 0u ? decodeOctahedral(aNormalTangent.zw) : vec3(0.0);
+#else
+    vec3 position = aPos;
+    vec3 normal   = aNormal;
+    vec3 tangent  = aTangent;
+#endif
+
+    mat3 normalMatrix = mat3(transpose(inverse(model)));
+
+    vec4 worldPos = model * vec4(position, 1.0);
     FragPos       = worldPos.xyz;
-    Normal        = mat3(transpose(inverse(model))) * aNormal;
+    Normal        = normalMatrix * normal;
+    Tangent       = mat3(model) * tangent;
     TexCoord      = aTexCoord;
 
     CurrClipPos = projection * view * worldPos;
-    PrevClipPos = prevMVP * vec4(aPos, 1.0);
+    PrevClipPos = prevMVP * vec4(position, 1.0);
 
-    gl_Position = CurrClipPos;
-}
\ No newline at end of file
+    // jitter only the rasterized position, motion vectors stay unjittered
+    gl_Position = CurrClipPos + vec4(jitter * CurrClipPos.w, 0.0, 0.0);
+}
@@ -8,6 +8,7 @@ uniform sampler2D gNormalRoughness;
 uniform sampler2D gMotionShadingModel;
 uniform sampler2D gDepth;
 
+uniform vec2 gBufferUVScale; // used region of the (over-allocated) gbuffer
 uniform mat4 invViewProjection;
 uniform vec3 viewPos;
 
@@ -36,6 +37,18 @@ uniform int              numPointLights;
 uniform DirectionalLight dirLights[MAX_DIR_LIGHTS];
 uniform PointLight       pointLights[MAX_POINT_LIGHTS];
 
+#ifdef GBUFFER_COMPACT
+vec3 decodeOctahedral(vec2 f)
+{
+    f       = f * 2.0 - 1.0;
+    vec3 n  = vec3(f.x, f.y, 1.0 - abs(f.x) - abs(f.y));
+    float t = clamp(-n.z, 0.0, 1.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+#endif
+
 vec3 reconstructWorldPos(vec2 texCoord, float depth)
 {
     vec4 clipPos  = vec4(texCoord * 2.0 - 1.0, depth * 2.0 - 1.0, 1.0);
@@ -132,9 +145,10 @@ vec3 calculatePointLight(PointLight light, vec3 fragPos, vec3 N, vec3 V, vec3 al
 
 void main()
 {
-    vec4  albedoMetallic  = texture(gAlbedoMetallic, TexCoord);
-    vec4  normalRoughness = texture(gNormalRoughness, TexCoord);
-    float depth           = texture(gDepth, TexCoord).r;
+    vec2  gBufferUV       = TexCoord * gBufferUVScale;
+    vec4  albedoMetallic  = texture(gAlbedoMetallic, gBufferUV);
+    vec4  normalRoughness = texture(gNormalRoughness, gBufferUV);
+    float depth           = texture(gDepth, gBufferUV).r;
 
     if (depth >= 1.0)
     {
@@ -143,8 +157,13 @@ void main()
 
     vec3  albedo    = albedoMetallic.rgb;
     float metallic  = albedoMetallic.a;
+#ifdef GBUFFER_COMPACT
+    vec3  normal    = decodeOctahedral(normalRoughness.rg);
+    float roughness = normalRoughness.b;
+#else
     vec3  normal    = normalize(normalRoughness.rgb * 2.0 - 1.0);
     float roughness = normalRoughness.a;
+#endif
 
     vec3 fragPos = reconstructWorldPos(TexCoord, depth);
     vec3 V       = normalize(viewPos - fragPos);
@@ -0,0 +1,63 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D currentColor; // jittered lighting result, render resolution
+uniform sampler2D historyColor; // previous resolved frame, output resolution
+uniform sampler2D gMotion;      // RG: current - previous uv
+
+uniform vec2 currentUVScale;   // used region of the (over-allocated) current / gbuffer textures
+uniform vec2 historyUVScale;   // used region of the history texture
+uniform vec2 currentTexelSize; // 1 / render resolution, in used-region uv
+uniform vec2 jitter;           // sub-pixel jitter of this frame, NDC
+uniform bool historyValid;
+
+const float FEEDBACK_MIN = 0.88;
+const float FEEDBACK_MAX = 0.97;
+
+// tonemapped weights keep bright pixels from dominating the blend
+vec3 toneMap(vec3 c) { return c / (1.0 + max(c.r, max(c.g, c.b))); }
+vec3 toneUnmap(vec3 c) { return c / max(1.0 - max(c.r, max(c.g, c.b)), 1e-4); }
+
+vec3 sampleCurrent(vec2 uv) { return toneMap(texture(currentColor, clamp(uv, 0.0, 1.0) * currentUVScale).rgb); }
+
+void main()
+{
+    // remove this frame's jitter, geometry was shifted by jitter * 0.5 in uv
+    vec2 uv = TexCoord + jitter * 0.5;
+
+    // neighbourhood of the current frame at render resolution
+    vec3 center = sampleCurrent(uv);
+    vec3 minColor = center;
+    vec3 maxColor = center;
+    for (int y = -1; y <= 1; ++y)
+    {
+        for (int x = -1; x <= 1; ++x)
+        {
+            if (x == 0 && y == 0)
+                continue;
+            vec3 c   = sampleCurrent(uv + vec2(x, y) * currentTexelSize);
+            minColor = min(minColor, c);
+            maxColor = max(maxColor, c);
+        }
+    }
+
+    vec2 motion = texture(gMotion, TexCoord * currentUVScale).rg;
+    vec2 prevUV = TexCoord - motion;
+
+    if (!historyValid || any(lessThan(prevUV, vec2(0.0))) || any(greaterThan(prevUV, vec2(1.0))))
+    {
+        FragColor = vec4(toneUnmap(center), 1.0);
+        return;
+    }
+
+    vec3 history = toneMap(texture(historyColor, prevUV * historyUVScale).rgb);
+    history      = clamp(history, minColor, maxColor);
+
+    // trust history less while moving fast, sub-pixel motion keeps accumulating
+    float speed    = length(motion / currentTexelSize);
+    float feedback = mix(FEEDBACK_MAX, FEEDBACK_MIN, clamp(speed, 0.0, 1.0));
+
+    FragColor = vec4(toneUnmap(mix(center, history, feedback)), 1.0);
+}
@@ -13,13 +13,22 @@ namespace RealmEngine
 
     void Engine::run()
     {
+        if (m_allocation_check_frames > 0 && !MemoryTracker::isEnabled())
+        {
+            LOG_ERROR("Allocation check needs a build with REALM_MEMORY_TRACKING");
+            m_allocation_check_failed = true;
+            return;
+        }
+
         // initialize camera
         m_camera = new Camera(glm::vec3(0.0f, 0.0f, 5.0f));
         g_context.m_input->setCamera(m_camera);
+        m_prev_camera_pos = m_camera->getPosition();
         // load model
-        m_model = new Model("../assets/model/backpack/backpack.obj");
+        m_model        = new Model("assets/model/backpack/backpack.obj");
+        m_model_handle = g_context.m_renderer->createRenderObject();
         // load shader
-        m_shader = new Shader("../shader/default_raster.vert", "../shader/default_raster.frag");
+        m_shader = new Shader("shader/default_raster.vert", "shader/default_raster.frag");
 
         while (!g_context.m_window->shouldClose())
         {
@@ -28,10 +37,19 @@ namespace RealmEngine
             m_delta_time        = current_frame - m_last_frame;
             m_last_frame        = current_frame;
 
+            size_t allocations_before = MemoryTracker::getTotalAllocations();
+
+            // GL work queued by jobs (e.g. uploads after a background load)
+            g_context.m_jobs->runMainThreadJobs();
+
             tick();
+
+            if (m_allocation_check_frames > 0 && !checkFrameAllocations(allocations_before))
+                break;
         }
 
         // clean assets
+        g_context.m_renderer->destroyRenderObject(m_model_handle);
         delete m_shader;
         delete m_model;
         delete m_camera;
@@ -44,57 +62,156 @@ namespace RealmEngine
         g_context.destroy();
     }
 
-    void Engine::tick()
+    /**
+     * @brief count this frame's heap allocations against the steady-state budget of zero
+     *
+     * Transient frame data lives in the FrameAllocator and job queues keep their storage, so once
+     * warmed up a frame allocates nothing. Returns false when the check is complete.
+     */
+    bool Engine::checkFrameAllocations(size_t allocations_before)
     {
-        logicalTick();
-        renderTick();
+        // sampled before logging, the log line's own allocations land outside the next frame's window
+        size_t allocations = MemoryTracker::getTotalAllocations() - allocations_before;
+        ++m_checked_frames;
+
+        if (m_checked_frames > m_ALLOCATION_WARMUP_FRAMES && allocations > 0)
+        {
+            m_allocation_check_failed = true;
+            LOG_ERROR("Steady-state frame " + std::to_string(m_checked_frames) + " made " +
+                      std::to_string(allocations) + " heap allocations");
+        }
+
+        if (m_checked_frames < m_ALLOCATION_WARMUP_FRAMES + m_allocation_check_frames)
+            return true;
+
+        if (m_allocation_check_failed)
+            LOG_ERROR("Allocation check failed");
+        else
+            LOG_INFO("Allocation check passed, " + std::to_string(m_allocation_check_frames) +
+                     " steady-state frames without heap allocations");
+
+        // per-subsystem totals, to see where a failing frame's allocations came from
+        MemoryTracker::dump();
+        return false;
     }
 
-    void Engine::logicalTick() const
+    void Engine::tick()
     {
-        // event handling
+        // glfw event polling must stay on the main thread
         g_context.m_window->tick();
-        g_context.m_input->tick(m_delta_time);
+
+        if (!m_pipelined)
+        {
+            logicalTick(m_snapshots[m_render_snapshot]);
+            renderTick(m_snapshots[m_render_snapshot]);
+            m_snapshot_ready = false;
+            return;
+        }
+
+        // prime the pipeline, or refill after running unpipelined
+        if (!m_snapshot_ready)
+            logicalTick(m_snapshots[m_render_snapshot]);
+
+        // next frame's logic runs on a worker while this frame is submitted
+        FrameSnapshot& next = m_snapshots[m_render_snapshot ^ 1];
+        JobCounter     logic_done;
+        g_context.m_jobs->submit([this, &next]() { logicalTick(next); }, &logic_done);
+
+        renderTick(m_snapshots[m_render_snapshot]);
+
+        g_context.m_jobs->wait(logic_done);
+        m_render_snapshot ^= 1;
+        m_snapshot_ready = true;
     }
 
-    void Engine::renderTick()
+    /**
+     * @brief advance simulation and collect what to draw, no GL calls (may run on a worker)
+     *
+     * Simulation runs in fixed steps; the remainder of the accumulator interpolates the camera
+     * between the previous and the current step.
+     */
+    void Engine::logicalTick(FrameSnapshot& snapshot)
     {
-        // update imgui
-        ImGui_ImplOpenGL3_NewFrame();
-        ImGui_ImplGlfw_NewFrame();
-        ImGui::NewFrame();
+        // clamp long stalls (breakpoints, window drags) instead of simulating them
+        m_accumulator += std::min(m_delta_time, m_MAX_FRAME_DELTA);
 
-        // render scene
-        glm::mat4 projection =
+        int steps = 0;
+        while (m_accumulator >= m_FIXED_TIMESTEP && steps < m_MAX_STEPS_PER_FRAME)
+        {
+            m_prev_camera_pos = m_camera->getPosition();
+            g_context.m_input->tick(m_FIXED_TIMESTEP);
+            m_accumulator -= m_FIXED_TIMESTEP;
+            ++steps;
+        }
+
+        // fell behind, drop the backlog rather than spiral
+        if (steps == m_MAX_STEPS_PER_FRAME)
+            m_accumulator = std::min(m_accumulator, m_FIXED_TIMESTEP);
+
+        float     alpha      = m_accumulator / m_FIXED_TIMESTEP;
+        glm::vec3 camera_pos = glm::mix(m_prev_camera_pos, m_camera->getPosition(), alpha);
+
+        snapshot.clear();
+
+        snapshot.projection =
             m_camera->getProjectionMatrix(static_cast<float>(g_context.m_window->getFramebufferWidth()) /
                                           static_cast<float>(g_context.m_window->getFramebufferHeight()));
-        glm::mat4 view       = m_camera->getViewMatrix();
-        glm::vec3 camera_pos = m_camera->getPosition();
+        // orientation comes straight from mouse input, only the simulated position is interpolated
+        snapshot.view       = glm::lookAt(camera_pos, camera_pos + m_camera->getFront(), m_camera->getUp());
+        snapshot.camera_pos = camera_pos;
+
+        snapshot.dir_lights.push_back({glm::vec3(0.2f, -1.0f, 0.3f), // 方向
+                                       glm::vec3(1.0f, 0.9f, 0.8f),  // 颜色
+                                       2.0f});                       // 强度
 
-        g_context.m_renderer->setMainCamera(view, projection, camera_pos);
+        PointLight point_light;
+        point_light.position  = glm::vec3(2.0f, 3.0f, 1.0f); // 位置
+        point_light.color     = glm::vec3(1.0f, 0.5f, 0.2f); // 颜色
+        point_light.intensity = 5.0f;                        // 强度
+        snapshot.point_lights.push_back(point_light);
 
-        g_context.m_renderer->addDirectionalLight(glm::vec3(0.2f, -1.0f, 0.3f), // 方向
-                                                  glm::vec3(1.0f, 0.9f, 0.8f),  // 颜色
-                                                  2.0f                          // 强度
-        );
+        snapshot.objects.push_back({m_model, glm::mat4(1.0f), m_model_handle});
+    }
 
-        g_context.m_renderer->addPointLight(glm::vec3(2.0f, 3.0f, 1.0f), // 位置
-                                            glm::vec3(1.0f, 0.5f, 0.2f), // 颜色
-                                            5.0f                         // 强度
-        );
+    void Engine::renderTick(const FrameSnapshot& snapshot)
+    {
+        // update imgui
+        {
+            MEMORY_SCOPE(MemoryTag::UI);
+            ImGui_ImplOpenGL3_NewFrame();
+            ImGui_ImplGlfw_NewFrame();
+            ImGui::NewFrame();
+        }
 
-        glm::mat4 model_matrix = glm::mat4(1.0f);
-        g_context.m_renderer->addRenderObject(m_model, model_matrix);
+        // render scene
+        g_context.m_renderer->setMainCamera(snapshot.view, snapshot.projection, snapshot.camera_pos);
+
+        for (const auto& light : snapshot.dir_lights)
+        {
+            g_context.m_renderer->addDirectionalLight(light.direction, light.color, light.intensity);
+        }
+        for (const auto& light : snapshot.point_lights)
+        {
+            g_context.m_renderer->addPointLight(light.position, light.color, light.intensity);
+        }
+        for (const auto& obj : snapshot.objects)
+        {
+            g_context.m_renderer->addRenderObject(obj.model, obj.model_matrix, obj.handle);
+        }
 
         g_context.m_renderer->renderFrame();
 
         // debug ui
-        drawDebugUI();
-        ImGui::Render();
-        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        {
+            MEMORY_SCOPE(MemoryTag::UI);
+            drawDebugUI();
+            ImGui::Render();
+            ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+        }
 
         // buffering...
         g_context.m_window->swapBuffers();
+        g_context.m_frame_pacer->endFrame();
     }
 
     void Engine::drawDebugUI()
@@ -108,7 +225,63 @@ namespace RealmEngine
         ImGui::Text("Framebuffer size: %d x %d",
                     g_context.m_window->getFramebufferWidth(),
                     g_context.m_window->getFramebufferHeight());
+        ImGui::Text("Render scale: %.2f (GPU %.2f ms / budget %.2f ms)",
+                    g_context.m_renderer->getRenderScale(),
+                    g_context.m_renderer->getGPUFrameTime(),
+                    g_context.m_renderer->getFrameTimeBudget());
+        ImGui::Text("GL state calls: %u issued, %u skipped",
+                    g_context.m_renderer->getStateStats().issued_calls,
+                    g_context.m_renderer->getStateStats().skipped_calls);
+
+        ClusterCullStats clusters = g_context.m_renderer->getClusterCullStats();
+        ImGui::Text("Meshlets: %u culled of %u", clusters.culled, clusters.tested);
+
+        const TextureStreamer::Stats& textures = g_context.m_renderer->getTextureStats();
+        ImGui::Text("Textures: %.1f / %.1f MB resident, %u of %u streaming, %.1f MB pending",
+                    static_cast<double>(textures.resident_bytes) / (1024.0 * 1024.0),
+                    static_cast<double>(g_context.m_renderer->getTextureStreamer()->getBudget()) / (1024.0 * 1024.0),
+                    textures.streaming_count,
+                    textures.texture_count,
+                    static_cast<double>(textures.pending_bytes) / (1024.0 * 1024.0));
+
+        const StagingRing::Stats& staging = g_context.m_renderer->getStagingStats();
+        ImGui::Text("Staging: %.1f MB uploaded, %.1f / %.1f MB in flight, %u full",
+                    static_cast<double>(staging.staged_bytes) / (1024.0 * 1024.0),
+                    static_cast<double>(staging.in_flight_bytes) / (1024.0 * 1024.0),
+                    static_cast<double>(staging.capacity) / (1024.0 * 1024.0),
+                    staging.failed_allocations);
+
+        const FramePacer::Stats& pacing = g_context.m_frame_pacer->getStats();
+        ImGui::Text("Frame time: avg %.2f ms, stddev %.2f ms, min %.2f / max %.2f ms",
+                    pacing.average_ms,
+                    pacing.stddev_ms,
+                    pacing.min_ms,
+                    pacing.max_ms);
+
+        int swap_mode = static_cast<int>(g_context.m_frame_pacer->getSwapMode());
+        if (ImGui::Combo("Swap mode", &swap_mode, "Immediate\0V-Sync\0Adaptive\0"))
+            g_context.m_frame_pacer->setSwapMode(static_cast<SwapMode>(swap_mode));
+
+        float target_fps = g_context.m_frame_pacer->getTargetFPS();
+        if (ImGui::SliderFloat("FPS limit (0 = off)", &target_fps, 0.0f, 240.0f, "%.0f"))
+            g_context.m_frame_pacer->setTargetFPS(target_fps);
+
+        ImGui::Checkbox("Pipelined frames", &m_pipelined);
         ImGui::Text("OpenGL Version: %s", glfwGetVersionString());
+
+        if (MemoryTracker::isEnabled() && ImGui::CollapsingHeader("Memory"))
+        {
+            for (size_t i = 0; i < static_cast<size_t>(MemoryTag::Count); ++i)
+            {
+                auto                    tag   = static_cast<MemoryTag>(i);
+                MemoryTracker::TagStats stats = MemoryTracker::getStats(tag);
+                ImGui::Text("%-8s %8.2f MB (peak %8.2f MB), %zu live",
+                            MemoryTracker::getTagName(tag),
+                            static_cast<double>(stats.current_bytes) / (1024.0 * 1024.0),
+                            static_cast<double>(stats.peak_bytes) / (1024.0 * 1024.0),
+                            stats.live_allocations);
+            }
+        }
         ImGui::End();
     }
 } // namespace RealmEngine
\ No newline at end of file
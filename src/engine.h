@@ -12,9 +12,13 @@
 #include <imgui_impl_glfw.h>
 #include <imgui_impl_opengl3.h>
 
+#include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstring>
+#include <vector>
 
+#include "render/pass/lighting_pass.h"
 #include "render/renderer.h"
 #include "resource/shader.h"
 #include "resource/camera.h"
@@ -22,6 +26,34 @@
 
 namespace RealmEngine
 {
+    /**
+     * @brief everything renderTick needs from the simulation, built by logicalTick
+     */
+    struct FrameSnapshot
+    {
+        struct Object
+        {
+            Model*             model {nullptr};
+            glm::mat4          model_matrix {1.0f};
+            RenderObjectHandle handle {g_invalid_render_object};
+        };
+
+        glm::mat4 view {1.0f};
+        glm::mat4 projection {1.0f};
+        glm::vec3 camera_pos {0.0f};
+
+        std::vector<DirectionalLight> dir_lights;
+        std::vector<PointLight>       point_lights;
+        std::vector<Object>           objects;
+
+        void clear()
+        {
+            dir_lights.clear();
+            point_lights.clear();
+            objects.clear();
+        }
+    };
+
     class Engine
     {
     public:
@@ -29,20 +61,56 @@ namespace RealmEngine
         void run();
         void terminate();
 
+        // opt-in: overlap frame N+1's logic with frame N's GL submission, costs one frame of input latency
+        void setPipelinedFrames(bool enabled) { m_pipelined = enabled; }
+        bool isPipelinedFrames() const { return m_pipelined; }
+
+        /**
+         * @brief run m_ALLOCATION_WARMUP_FRAMES, then frames more that must not touch the heap, then stop
+         *
+         * Needs REALM_MEMORY_TRACKING. Every allocating frame is logged, see hasAllocationCheckFailed.
+         */
+        void setAllocationCheck(uint32_t frames) { m_allocation_check_frames = frames; }
+        bool hasAllocationCheckFailed() const { return m_allocation_check_failed; }
+
+        // streaming, shader and cache warm-up may allocate during these
+        static constexpr uint32_t m_ALLOCATION_WARMUP_FRAMES = 300;
+
     protected:
         void tick();
-        void logicalTick() const;
-        void renderTick();
+        void logicalTick(FrameSnapshot& snapshot);
+        void renderTick(const FrameSnapshot& snapshot);
 
     private:
         float m_delta_time {0.0f};
         float m_last_frame {0.0f};
 
+        // fixed-rate simulation, rendering interpolates between the last two steps
+        static constexpr float m_FIXED_TIMESTEP      = 1.0f / 60.0f;
+        static constexpr float m_MAX_FRAME_DELTA     = 0.25f;
+        static constexpr int   m_MAX_STEPS_PER_FRAME = 5;
+
+        float     m_accumulator {0.0f};
+        glm::vec3 m_prev_camera_pos {0.0f};
+
+        // double-buffered: logic writes one while the main thread renders the other
+        std::array<FrameSnapshot, 2> m_snapshots;
+        uint32_t                     m_render_snapshot {0};
+        bool                         m_snapshot_ready {false};
+        bool                         m_pipelined {false};
+
+        uint32_t m_allocation_check_frames {0};
+        uint32_t m_checked_frames {0};
+        bool     m_allocation_check_failed {false};
+
         // temp var , removed latter(added to rendering system)
         Camera* m_camera {nullptr};
         Model*  m_model {nullptr};
         Shader* m_shader {nullptr};
 
+        RenderObjectHandle m_model_handle {g_invalid_render_object};
+
         void drawDebugUI();
+        bool checkFrameAllocations(size_t allocations_before);
     };
 } // namespace RealmEngine
\ No newline at end of file
@@ -0,0 +1,77 @@
+#include "frame_allocator.h"
+#include "global.h"
+#include "logger.h"
+
+#include <cstdint>
+#include <string>
+
+namespace RealmEngine
+{
+    FrameArena::FrameArena(size_t capacity) : m_capacity(capacity)
+    {
+        if (m_capacity > 0)
+            m_buffer = std::make_unique<std::byte[]>(m_capacity);
+    }
+
+    void FrameArena::reset()
+    {
+        // last use did not fit, grow so the same load fits next time
+        if (m_overflow_bytes > 0)
+        {
+            size_t new_capacity = (m_capacity + m_overflow_bytes) * 3 / 2;
+            LOG_WARN("FrameArena overflowed by " + std::to_string(m_overflow_bytes) + " bytes, growing to " +
+                     std::to_string(new_capacity));
+
+            m_buffer   = std::make_unique<std::byte[]>(new_capacity);
+            m_capacity = new_capacity;
+        }
+
+        m_overflow.release();
+        m_overflow_bytes = 0;
+        m_offset         = 0;
+    }
+
+    void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+    {
+        auto   base    = reinterpret_cast<uintptr_t>(m_buffer.get());
+        size_t aligned = ((base + m_offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+
+        if (m_buffer && aligned + bytes <= m_capacity)
+        {
+            m_offset = aligned + bytes;
+            return m_buffer.get() + aligned;
+        }
+
+        m_overflow_bytes += bytes + alignment;
+        return m_overflow.allocate(bytes, alignment);
+    }
+
+    void FrameAllocator::initialize(size_t capacity)
+    {
+        for (auto& arena : m_arenas)
+        {
+            std::destroy_at(&arena);
+            ::new (&arena) FrameArena(capacity);
+        }
+        m_frame_index = 0;
+
+        LOG_INFO("FrameAllocator initialized");
+    }
+
+    void FrameAllocator::terminate()
+    {
+        for (auto& arena : m_arenas)
+        {
+            std::destroy_at(&arena);
+            ::new (&arena) FrameArena();
+        }
+
+        LOG_INFO("FrameAllocator terminated");
+    }
+
+    void FrameAllocator::nextFrame()
+    {
+        m_frame_index = (m_frame_index + 1) % m_FRAME_COUNT;
+        m_arenas[m_frame_index].reset();
+    }
+} // namespace RealmEngine
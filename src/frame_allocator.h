@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+namespace RealmEngine
+{
+    /**
+     * @brief bump allocator for data that lives at most a few frames, freed all at once on reset
+     *
+     * Not thread-safe, meant for the render thread. Requests past the block spill into an
+     * overflow resource and the block grows on the next reset, so steady state never spills.
+     */
+    class FrameArena final : public std::pmr::memory_resource
+    {
+    public:
+        explicit FrameArena(size_t capacity = 0);
+
+        void reset();
+
+        size_t getUsed() const { return m_offset; }
+        size_t getCapacity() const { return m_capacity; }
+        size_t getOverflow() const { return m_overflow_bytes; }
+
+    private:
+        std::unique_ptr<std::byte[]>        m_buffer;
+        size_t                              m_capacity {0};
+        size_t                              m_offset {0};
+        size_t                              m_overflow_bytes {0};
+        std::pmr::monotonic_buffer_resource m_overflow {std::pmr::new_delete_resource()};
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void  do_deallocate(void* /*ptr*/, size_t /*bytes*/, size_t /*alignment*/) override {}
+        bool  do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+    };
+
+    /**
+     * @brief ring of FrameArenas, memory handed out in frame N stays valid until frame N + m_FRAME_COUNT
+     */
+    class FrameAllocator
+    {
+    public:
+        static constexpr int    m_FRAME_COUNT      = 3;
+        static constexpr size_t m_DEFAULT_CAPACITY = 1 << 20;
+
+        void initialize(size_t capacity = m_DEFAULT_CAPACITY);
+        void terminate();
+
+        // recycle the oldest arena and make it current
+        void nextFrame();
+
+        std::pmr::memory_resource* getResource() { return &m_arenas[m_frame_index]; }
+        const FrameArena&          getCurrentArena() const { return m_arenas[m_frame_index]; }
+
+    private:
+        std::array<FrameArena, m_FRAME_COUNT> m_arenas;
+        int                                   m_frame_index {0};
+    };
+
+    /**
+     * @brief point a pmr container at a new memory resource, dropping its contents
+     *
+     * pmr containers keep their resource across assignment and swap, so the container is rebuilt in place.
+     */
+    template<typename Container>
+    void rebindContainer(Container& container, std::pmr::memory_resource* resource)
+    {
+        std::destroy_at(&container);
+        ::new (&container) Container(resource);
+    }
+} // namespace RealmEngine
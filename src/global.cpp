@@ -7,19 +7,44 @@ namespace RealmEngine
     void Context::create()
     {
         // initialize logger system
-        m_logger = std::make_shared<Logger>();
+        {
+            MEMORY_SCOPE(MemoryTag::Logger);
+            m_logger = std::make_shared<Logger>();
+        }
+
+        // initialize virtual file system, mounts must exist before anything loads
+        m_vfs = std::make_shared<VirtualFileSystem>();
+        m_vfs->initialize();
+
+        // initialize job system, the calling thread becomes the main (GL) thread
+        m_jobs = std::make_shared<JobSystem>();
+        m_jobs->initialize();
+
+        // initialize per-frame arenas
+        m_frame_allocator = std::make_shared<FrameAllocator>();
+        m_frame_allocator->initialize();
 
         // initialize window system
         m_window = std::make_shared<Window>(640, 480, "RealmEngine");
         m_window->initialize();
 
+        // initialize frame pacing, takes over the swap interval
+        m_frame_pacer = std::make_shared<FramePacer>();
+        m_frame_pacer->initialize(m_window.get());
+
         // initialize resource manager
-        m_resource = std::make_shared<Resource>();
-        m_resource->initialize();
+        {
+            MEMORY_SCOPE(MemoryTag::Resource);
+            m_resource = std::make_shared<Resource>();
+            m_resource->initialize();
+        }
 
         // initialize rendering system
-        m_renderer = std::make_shared<Renderer>();
-        m_renderer->initialize();
+        {
+            MEMORY_SCOPE(MemoryTag::Render);
+            m_renderer = std::make_shared<Renderer>();
+            m_renderer->initialize();
+        }
 
         // initialize input system
         m_input = std::make_shared<Input>();
@@ -31,13 +56,24 @@ namespace RealmEngine
         m_input->terminate();
         m_resource->terminate();
         m_renderer->terminate();
+        m_frame_pacer->terminate();
         m_window->terminate();
+        m_frame_allocator->terminate();
+        m_jobs->terminate();
+        m_vfs->terminate();
 
         // reset ptrs
         m_input.reset();
         m_renderer.reset();
         m_resource.reset();
+        m_frame_pacer.reset();
         m_window.reset();
+        m_frame_allocator.reset();
+        m_jobs.reset();
+        m_vfs.reset();
+
+        // everything but the logger is gone, what is still charged to a subsystem leaked
+        MemoryTracker::reportLeaks();
         m_logger.reset();
     }
 
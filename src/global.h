@@ -2,19 +2,28 @@
 
 #include <memory>
 
+#include "frame_allocator.h"
 #include "input.h"
+#include "job_system.h"
 #include "logger.h"
+#include "memory_tracker.h"
+#include "render/frame_pacer.h"
 #include "render/renderer.h"
 #include "render/window.h"
 #include "resource/resource.h"
+#include "resource/vfs.h"
 
 namespace RealmEngine
 {
     class Logger;
     class Input;
+    class JobSystem;
+    class FrameAllocator;
+    class FramePacer;
     class Window;
     class Renderer;
     class ResourceManager;
+    class VirtualFileSystem;
 
     class Context
     {
@@ -22,11 +31,19 @@ namespace RealmEngine
         void create();
         void destroy();
 
-        std::shared_ptr<Logger>   m_logger;
-        std::shared_ptr<Window>   m_window;
-        std::shared_ptr<Resource> m_resource;
-        std::shared_ptr<Renderer> m_renderer;
-        std::shared_ptr<Input>    m_input;
+        std::shared_ptr<Logger>     m_logger;
+        std::shared_ptr<JobSystem>  m_jobs;
+
+        // every asset and shader read goes through here, see VirtualFileSystem
+        std::shared_ptr<VirtualFileSystem> m_vfs;
+
+        // transient per-frame memory for the render thread, see FrameAllocator
+        std::shared_ptr<FrameAllocator> m_frame_allocator;
+        std::shared_ptr<Window>     m_window;
+        std::shared_ptr<FramePacer> m_frame_pacer;
+        std::shared_ptr<Resource>   m_resource;
+        std::shared_ptr<Renderer>   m_renderer;
+        std::shared_ptr<Input>      m_input;
     };
 
     extern Context g_context;
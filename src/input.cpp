@@ -19,7 +19,17 @@ namespace RealmEngine
         LOG_INFO("Input System initialized");
     }
 
-    void Input::tick(float deltaTime) { m_delta_time = deltaTime; }
+    void Input::tick(float deltaTime)
+    {
+        if (!m_camera)
+            return;
+
+        for (size_t i = 0; i < m_movement_held.size(); ++i)
+        {
+            if (m_movement_held[i])
+                m_camera->processKeyboard(static_cast<Camera::Movement>(i), deltaTime);
+        }
+    }
 
     void Input::terminate()
     {
@@ -69,19 +79,24 @@ namespace RealmEngine
         }
     }
 
+    /**
+     * @brief only track held keys, movement is applied per simulation step so it does not
+     *        depend on frame rate or key-repeat rate
+     */
     void Input::movementCallback(int key, int action)
     {
-        if (!m_camera)
+        if (action == GLFW_REPEAT)
             return;
 
-        if (key == GLFW_KEY_W && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            m_camera->processKeyboard(Camera::Movement::FORWARD, m_delta_time);
-        if (key == GLFW_KEY_A && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            m_camera->processKeyboard(Camera::Movement::LEFT, m_delta_time);
-        if (key == GLFW_KEY_S && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            m_camera->processKeyboard(Camera::Movement::BACKWARD, m_delta_time);
-        if (key == GLFW_KEY_D && (action == GLFW_PRESS || action == GLFW_REPEAT))
-            m_camera->processKeyboard(Camera::Movement::RIGHT, m_delta_time);
+        bool held = action == GLFW_PRESS;
+        if (key == GLFW_KEY_W)
+            m_movement_held[static_cast<size_t>(Camera::Movement::FORWARD)] = held;
+        if (key == GLFW_KEY_A)
+            m_movement_held[static_cast<size_t>(Camera::Movement::LEFT)] = held;
+        if (key == GLFW_KEY_S)
+            m_movement_held[static_cast<size_t>(Camera::Movement::BACKWARD)] = held;
+        if (key == GLFW_KEY_D)
+            m_movement_held[static_cast<size_t>(Camera::Movement::RIGHT)] = held;
     }
 
     void Input::toggleMouseCapture()
@@ -94,6 +109,7 @@ namespace RealmEngine
         }
 
         m_first_mouse = true;
+        m_movement_held.fill(false);
     }
 
 } // namespace RealmEngine
\ No newline at end of file
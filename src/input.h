@@ -7,6 +7,8 @@
 #include "render/window.h"
 #include "resource/camera.h"
 
+#include <array>
+
 namespace RealmEngine
 {
     class Input
@@ -19,6 +21,7 @@ namespace RealmEngine
         void setCamera(Camera* camera);
         void terminate();
 
+        // one fixed simulation step, applies held movement keys
         void tick(float deltaTime);
 
         bool isMouseCaptured() const { return m_mouse_captured; }
@@ -37,8 +40,10 @@ namespace RealmEngine
         float m_last_mouse_x {320.0f};
         float m_last_mouse_y {240.0f};
 
-        bool  m_first_mouse {true};
-        bool  m_mouse_captured {true};
-        float m_delta_time {0.0f};
+        bool m_first_mouse {true};
+        bool m_mouse_captured {true};
+
+        // indexed by Camera::Movement, written by key callbacks, consumed by tick
+        std::array<bool, 4> m_movement_held {};
     };
 } // namespace RealmEngine
\ No newline at end of file
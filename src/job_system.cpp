@@ -0,0 +1,339 @@
+#include "job_system.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <string>
+
+namespace RealmEngine
+{
+    namespace
+    {
+        // index of the worker queue owned by the current thread, -1 outside workers
+        thread_local int t_worker_index = -1;
+    } // namespace
+
+    void JobSystem::initialize(uint32_t worker_count)
+    {
+        if (m_running)
+            return;
+
+        if (worker_count == 0)
+        {
+            uint32_t hardware_threads = std::thread::hardware_concurrency();
+            worker_count              = hardware_threads > 1 ? hardware_threads - 1 : 1;
+        }
+
+        m_main_thread = std::this_thread::get_id();
+        m_running     = true;
+
+        m_queues.clear();
+        for (uint32_t i = 0; i < worker_count; ++i)
+        {
+            m_queues.push_back(std::make_unique<JobQueue>());
+        }
+
+        for (uint32_t i = 0; i < worker_count; ++i)
+        {
+            m_workers.emplace_back([this, i]() { workerLoop(i); });
+        }
+
+        LOG_INFO("JobSystem initialized with " + std::to_string(worker_count) + " workers");
+    }
+
+    void JobSystem::terminate()
+    {
+        if (!m_running)
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+            m_running = false;
+        }
+        m_wake.notify_all();
+
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+        m_workers.clear();
+
+        if (m_queued.load() > 0 || !m_main_queue.jobs.empty() || !m_parked.empty())
+            LOG_WARN("JobSystem terminated with unfinished jobs");
+
+        m_queues.clear();
+        m_main_queue.jobs.clear();
+        m_parked.clear();
+        m_queued = 0;
+
+        LOG_INFO("JobSystem terminated");
+    }
+
+    void JobSystem::submit(JobFunc func, JobCounter* counter, const JobCounter* dependency, Affinity affinity)
+    {
+        if (counter)
+            counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+
+        MemoryTag memory_tag = MemoryTracker::isEnabled() ? MemoryTracker::getCurrentTag() : MemoryTag::General;
+        Job       job {std::move(func), counter, dependency, affinity, memory_tag};
+
+        if (dependency)
+        {
+            // execute() drops the counter to zero under this lock, so either we see it done or it sees us
+            std::lock_guard<std::mutex> lock(m_parked_mutex);
+            if (!dependency->isDone())
+            {
+                m_parked[dependency].push_back(std::move(job));
+                return;
+            }
+        }
+
+        enqueue(std::move(job));
+    }
+
+    // job is ready to run, hand it to the main thread or a worker
+    void JobSystem::enqueue(Job&& job)
+    {
+        if (job.affinity == Affinity::MainThread)
+        {
+            std::lock_guard<std::mutex> lock(m_main_queue.mutex);
+            m_main_queue.jobs.pushBack(std::move(job));
+            return;
+        }
+
+        if (m_queues.empty())
+        {
+            LOG_WARN("JobSystem not running, executing job inline");
+            execute(std::move(job));
+            return;
+        }
+
+        // workers keep their own jobs local, everybody else spreads round-robin
+        uint32_t queue_index = t_worker_index >= 0 ? static_cast<uint32_t>(t_worker_index)
+                                                   : m_next_queue.fetch_add(1) % m_queues.size();
+        push(queue_index, std::move(job));
+    }
+
+    void JobSystem::parallelFor(size_t                                     count,
+                                size_t                                     batch_size,
+                                const std::function<void(size_t, size_t)>& func,
+                                JobCounter*                                counter)
+    {
+        batch_size = std::max<size_t>(batch_size, 1);
+
+        // shared so the batches do not each copy the callable
+        auto shared_func = std::make_shared<std::function<void(size_t, size_t)>>(func);
+        for (size_t begin = 0; begin < count; begin += batch_size)
+        {
+            size_t end = std::min(begin + batch_size, count);
+            submit([shared_func, begin, end]() { (*shared_func)(begin, end); }, counter);
+        }
+    }
+
+    void JobSystem::wait(const JobCounter& counter)
+    {
+        const bool main_thread = isMainThread();
+
+        while (!counter.isDone())
+        {
+            bool ran = false;
+
+            Job job;
+            if (main_thread && popMainThreadJob(job))
+            {
+                execute(std::move(job));
+                ran = true;
+            }
+            if (popJob(t_worker_index, job))
+            {
+                execute(std::move(job));
+                ran = true;
+            }
+
+            if (!ran)
+                std::this_thread::yield();
+        }
+    }
+
+    void JobSystem::runMainThreadJobs()
+    {
+        if (!isMainThread())
+        {
+            LOG_ERROR("JobSystem::runMainThreadJobs called off the main thread");
+            return;
+        }
+
+        // only what is queued right now, jobs these release run next time
+        size_t count = 0;
+        {
+            std::lock_guard<std::mutex> lock(m_main_queue.mutex);
+            count = m_main_queue.jobs.size();
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            Job job;
+            if (!popMainThreadJob(job))
+                break;
+
+            execute(std::move(job));
+        }
+    }
+
+    void JobSystem::workerLoop(uint32_t index)
+    {
+        t_worker_index = static_cast<int>(index);
+
+        while (true)
+        {
+            Job job;
+            if (popJob(t_worker_index, job))
+            {
+                execute(std::move(job));
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(m_wake_mutex);
+            m_wake.wait(lock, [this]() { return !m_running || m_queued.load() > 0; });
+
+            if (!m_running)
+                break;
+        }
+
+        t_worker_index = -1;
+    }
+
+    void JobSystem::push(uint32_t queue_index, Job&& job)
+    {
+        {
+            JobQueue&                   queue = *m_queues[queue_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.jobs.pushBack(std::move(job));
+        }
+
+        m_queued.fetch_add(1);
+        {
+            // pairs with the predicate check in workerLoop, avoids a lost wake-up
+            std::lock_guard<std::mutex> lock(m_wake_mutex);
+        }
+        m_wake.notify_one();
+    }
+
+    bool JobSystem::popJob(int own_index, Job& job)
+    {
+        const size_t queue_count = m_queues.size();
+        if (queue_count == 0)
+            return false;
+
+        // own queue from the back (hot in cache), then steal from the front of the others
+        if (own_index >= 0)
+        {
+            JobQueue&                   queue = *m_queues[own_index];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                queue.jobs.popBack(job);
+                m_queued.fetch_sub(1);
+                return true;
+            }
+        }
+
+        size_t start = own_index >= 0 ? static_cast<size_t>(own_index) + 1 : 0;
+        for (size_t i = 0; i < queue_count; ++i)
+        {
+            size_t victim = (start + i) % queue_count;
+            if (static_cast<int>(victim) == own_index)
+                continue;
+
+            JobQueue&                   queue = *m_queues[victim];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (!queue.jobs.empty())
+            {
+                queue.jobs.popFront(job);
+                m_queued.fetch_sub(1);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool JobSystem::popMainThreadJob(Job& job)
+    {
+        std::lock_guard<std::mutex> lock(m_main_queue.mutex);
+        if (m_main_queue.jobs.empty())
+            return false;
+
+        m_main_queue.jobs.popFront(job);
+        return true;
+    }
+
+    /**
+     * @brief run a popped job, then queue the jobs parked on its counter if it was the last one
+     *
+     * The counter is only used as a key after it reaches zero, a waiter may already have destroyed it.
+     */
+    void JobSystem::execute(Job&& job)
+    {
+        if (job.func)
+        {
+            MEMORY_SCOPE(job.memory_tag);
+            job.func();
+        }
+
+        if (!job.counter)
+            return;
+
+        std::vector<Job> released;
+        {
+            std::lock_guard<std::mutex> lock(m_parked_mutex);
+            if (job.counter->m_pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+
+            auto it = m_parked.find(job.counter);
+            if (it == m_parked.end())
+                return;
+            released = std::move(it->second);
+            m_parked.erase(it);
+        }
+
+        for (Job& parked : released)
+            enqueue(std::move(parked));
+    }
+
+    void JobSystem::JobRing::pushBack(Job&& job)
+    {
+        if (count == slots.size())
+        {
+            std::vector<Job> grown(std::max<size_t>(slots.size() * 2, 64));
+            for (size_t i = 0; i < count; ++i)
+                grown[i] = std::move(slots[(head + i) % slots.size()]);
+            slots.swap(grown);
+            head = 0;
+        }
+
+        slots[(head + count) % slots.size()] = std::move(job);
+        ++count;
+    }
+
+    void JobSystem::JobRing::popBack(Job& job)
+    {
+        --count;
+        job = std::move(slots[(head + count) % slots.size()]);
+    }
+
+    void JobSystem::JobRing::popFront(Job& job)
+    {
+        job  = std::move(slots[head]);
+        head = (head + 1) % slots.size();
+        --count;
+    }
+
+    void JobSystem::JobRing::clear()
+    {
+        // drop the callables, keep the storage
+        for (size_t i = 0; i < count; ++i)
+            slots[(head + i) % slots.size()] = Job {};
+        head  = 0;
+        count = 0;
+    }
+} // namespace RealmEngine
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "memory_tracker.h"
+
+namespace RealmEngine
+{
+    /**
+     * @brief counts unfinished jobs, used to wait on a group or to gate dependent jobs
+     */
+    class JobCounter
+    {
+    public:
+        bool     isDone() const { return m_pending.load(std::memory_order_acquire) == 0; }
+        uint32_t getPending() const { return m_pending.load(std::memory_order_acquire); }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<uint32_t> m_pending {0};
+    };
+
+    /**
+     * @brief work-stealing task scheduler, one deque per worker thread
+     *
+     * Owners pop their own deque LIFO, idle workers steal FIFO from the others.
+     * Jobs with MainThread affinity (GL work) only run inside runMainThreadJobs() or wait() on
+     * the main thread. Waiting never blocks idle: the waiting thread executes jobs itself.
+     * Jobs with a pending dependency are parked off the queues and queued when it finishes.
+     */
+    class JobSystem
+    {
+    public:
+        using JobFunc = std::function<void()>;
+
+        enum class Affinity : uint8_t
+        {
+            Any,
+            MainThread,
+        };
+
+        ~JobSystem() { terminate(); }
+
+        // worker_count 0 = one worker per hardware thread besides the main thread
+        void initialize(uint32_t worker_count = 0);
+        void terminate();
+
+        // counter is incremented now and decremented when the job finished,
+        // the job is not started before dependency (if any) is done
+        void submit(JobFunc           func,
+                    JobCounter*       counter    = nullptr,
+                    const JobCounter* dependency = nullptr,
+                    Affinity          affinity   = Affinity::Any);
+
+        // func(begin, end) over [0, count) in batches of batch_size
+        void parallelFor(size_t                                     count,
+                         size_t                                     batch_size,
+                         const std::function<void(size_t, size_t)>& func,
+                         JobCounter*                                counter);
+
+        void wait(const JobCounter& counter);
+        void runMainThreadJobs();
+
+        uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+        bool     isMainThread() const { return std::this_thread::get_id() == m_main_thread; }
+
+    private:
+        struct Job
+        {
+            JobFunc           func;
+            JobCounter*       counter {nullptr};
+            const JobCounter* dependency {nullptr};
+            Affinity          affinity {Affinity::Any};
+            MemoryTag         memory_tag {MemoryTag::General}; // charged like the submitting code
+        };
+
+        // circular buffer that only grows, a warmed-up queue pushes and pops without touching the heap
+        struct JobRing
+        {
+            std::vector<Job> slots;
+            size_t           head {0};
+            size_t           count {0};
+
+            bool   empty() const { return count == 0; }
+            size_t size() const { return count; }
+            void   pushBack(Job&& job);
+            void   popBack(Job& job);
+            void   popFront(Job& job);
+            void   clear();
+        };
+
+        struct JobQueue
+        {
+            std::mutex mutex;
+            JobRing    jobs;
+        };
+
+        std::vector<std::thread>               m_workers;
+        std::vector<std::unique_ptr<JobQueue>> m_queues; // one per worker
+        JobQueue                               m_main_queue;
+
+        std::atomic<bool>     m_running {false};
+        std::atomic<uint32_t> m_queued {0}; // jobs in worker queues
+        std::atomic<uint32_t> m_next_queue {0};
+
+        // keyed by dependency, also held while a counter is decremented so parking cannot miss the last job
+        std::mutex                                              m_parked_mutex;
+        std::unordered_map<const JobCounter*, std::vector<Job>> m_parked;
+
+        std::mutex              m_wake_mutex;
+        std::condition_variable m_wake;
+
+        std::thread::id m_main_thread;
+
+        void workerLoop(uint32_t index);
+        void enqueue(Job&& job);
+        void push(uint32_t queue_index, Job&& job);
+        bool popJob(int own_index, Job& job);
+        bool popMainThreadJob(Job& job);
+        void execute(Job&& job);
+    };
+} // namespace RealmEngine
@@ -7,6 +7,7 @@
 #include <spdlog/logger.h>
 
 #include "global.h"
+#include "memory_tracker.h"
 
 namespace RealmEngine
 {
@@ -37,6 +38,8 @@ namespace RealmEngine
         template<typename... TARGS>
         void log(const LogLevel level, TARGS&&... args) const
         {
+            MEMORY_SCOPE(MemoryTag::Logger);
+
             switch (level)
             {
                 case LogLevel::debug:
@@ -1,12 +1,42 @@
 #include "engine.h"
+#include "global.h"
+#include "resource/mesh_cache.h"
 
-int main(int /*argc*/, const char** /*argv*/)
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+int main(int argc, const char** argv)
 {
+    // RealmEngine --pack <directory> <archive.pak>: build a vfs archive and exit without booting
+    if (argc == 4 && std::string(argv[1]) == "--pack")
+    {
+        RealmEngine::g_context.m_logger = std::make_shared<RealmEngine::Logger>();
+        bool packed = RealmEngine::PackArchive::packDirectory(argv[2], argv[3]);
+        RealmEngine::g_context.m_logger.reset();
+        return packed ? 0 : 1;
+    }
+
+    // RealmEngine --check-mesh-cache <directory>: fail unless corrupt cooked files are rejected and recooked
+    if (argc == 3 && std::string(argv[1]) == "--check-mesh-cache")
+    {
+        RealmEngine::g_context.m_logger = std::make_shared<RealmEngine::Logger>();
+        RealmEngine::g_context.m_vfs    = std::make_shared<RealmEngine::VirtualFileSystem>();
+        bool passed                     = RealmEngine::MeshCache::checkCorruptFiles(argv[2]);
+        RealmEngine::g_context.m_vfs.reset();
+        RealmEngine::g_context.m_logger.reset();
+        return passed ? 0 : 1;
+    }
+
     RealmEngine::Engine* engine = new RealmEngine::Engine();
 
+    // RealmEngine --check-allocations [frames]: fail unless steady-state frames make no heap allocations
+    if (argc >= 2 && std::string(argv[1]) == "--check-allocations")
+        engine->setAllocationCheck(argc >= 3 ? static_cast<uint32_t>(std::strtoul(argv[2], nullptr, 10)) : 300);
+
     engine->boot();
     engine->run();
     engine->terminate();
 
-    return 0;
-}
\ No newline at end of file
+    return engine->hasAllocationCheckFailed() ? 1 : 0;
+}
@@ -0,0 +1,213 @@
+#include "memory_tracker.h"
+#include "global.h"
+#include "logger.h"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace RealmEngine
+{
+    namespace
+    {
+        constexpr size_t g_tag_count = static_cast<size_t>(MemoryTag::Count);
+
+        struct AtomicTagStats
+        {
+            std::atomic<size_t> current_bytes {0};
+            std::atomic<size_t> peak_bytes {0};
+            std::atomic<size_t> total_allocations {0};
+            std::atomic<size_t> live_allocations {0};
+        };
+
+        // constant-initialized, usable from operator new before any static constructor ran
+        std::array<AtomicTagStats, g_tag_count> g_tag_stats;
+
+        thread_local MemoryTag t_current_tag = MemoryTag::General;
+
+        std::string formatStats(MemoryTag tag, const MemoryTracker::TagStats& stats)
+        {
+            char buffer[160];
+            std::snprintf(buffer,
+                          sizeof(buffer),
+                          "%-8s current %.2f MB, peak %.2f MB, %zu live / %zu total allocations",
+                          MemoryTracker::getTagName(tag),
+                          static_cast<double>(stats.current_bytes) / (1024.0 * 1024.0),
+                          static_cast<double>(stats.peak_bytes) / (1024.0 * 1024.0),
+                          stats.live_allocations,
+                          stats.total_allocations);
+            return buffer;
+        }
+    } // namespace
+
+    const char* MemoryTracker::getTagName(MemoryTag tag)
+    {
+        switch (tag)
+        {
+            case MemoryTag::General:
+                return "General";
+            case MemoryTag::Resource:
+                return "Resource";
+            case MemoryTag::Render:
+                return "Render";
+            case MemoryTag::Logger:
+                return "Logger";
+            case MemoryTag::UI:
+                return "UI";
+            default:
+                return "Unknown";
+        }
+    }
+
+    MemoryTracker::TagStats MemoryTracker::getStats(MemoryTag tag)
+    {
+        const AtomicTagStats& src = g_tag_stats[static_cast<size_t>(tag)];
+
+        TagStats stats;
+        stats.current_bytes     = src.current_bytes.load(std::memory_order_relaxed);
+        stats.peak_bytes        = src.peak_bytes.load(std::memory_order_relaxed);
+        stats.total_allocations = src.total_allocations.load(std::memory_order_relaxed);
+        stats.live_allocations  = src.live_allocations.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    size_t MemoryTracker::getTotalAllocations()
+    {
+        size_t total = 0;
+        for (const AtomicTagStats& stats : g_tag_stats)
+            total += stats.total_allocations.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    void MemoryTracker::dump()
+    {
+        if (!isEnabled())
+        {
+            LOG_INFO("Memory tracking disabled, build with REALM_MEMORY_TRACKING");
+            return;
+        }
+
+        for (size_t i = 0; i < g_tag_count; ++i)
+        {
+            auto tag = static_cast<MemoryTag>(i);
+            LOG_INFO(formatStats(tag, getStats(tag)));
+        }
+    }
+
+    void MemoryTracker::reportLeaks()
+    {
+        if (!isEnabled())
+            return;
+
+        // General holds statics and Logger is still alive while reporting, neither is a leak
+        bool leaked = false;
+        for (size_t i = 0; i < g_tag_count; ++i)
+        {
+            auto tag = static_cast<MemoryTag>(i);
+            if (tag == MemoryTag::General || tag == MemoryTag::Logger)
+                continue;
+
+            TagStats stats = getStats(tag);
+            if (stats.live_allocations > 0)
+            {
+                LOG_WARN("Memory leak: " + formatStats(tag, stats));
+                leaked = true;
+            }
+        }
+
+        if (!leaked)
+            LOG_INFO("No subsystem memory leaks detected");
+    }
+
+    MemoryTag MemoryTracker::getCurrentTag() { return t_current_tag; }
+
+    void MemoryTracker::setCurrentTag(MemoryTag tag) { t_current_tag = tag; }
+
+    void MemoryTracker::recordAlloc(MemoryTag tag, size_t bytes)
+    {
+        AtomicTagStats& stats = g_tag_stats[static_cast<size_t>(tag)];
+
+        size_t current = stats.current_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        stats.total_allocations.fetch_add(1, std::memory_order_relaxed);
+        stats.live_allocations.fetch_add(1, std::memory_order_relaxed);
+
+        size_t peak = stats.peak_bytes.load(std::memory_order_relaxed);
+        while (current > peak && !stats.peak_bytes.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    void MemoryTracker::recordFree(MemoryTag tag, size_t bytes)
+    {
+        AtomicTagStats& stats = g_tag_stats[static_cast<size_t>(tag)];
+        stats.current_bytes.fetch_sub(bytes, std::memory_order_relaxed);
+        stats.live_allocations.fetch_sub(1, std::memory_order_relaxed);
+    }
+} // namespace RealmEngine
+
+#ifdef REALM_MEMORY_TRACKING
+namespace
+{
+    // prepended to every block, keeps the default new alignment
+    struct alignas(alignof(std::max_align_t)) AllocationHeader
+    {
+        size_t                 size;
+        RealmEngine::MemoryTag tag;
+    };
+
+    void* trackedAlloc(size_t size) noexcept
+    {
+        void* block = std::malloc(sizeof(AllocationHeader) + size);
+        if (!block)
+            return nullptr;
+
+        auto* header = static_cast<AllocationHeader*>(block);
+        header->size = size;
+        header->tag  = RealmEngine::MemoryTracker::getCurrentTag();
+        RealmEngine::MemoryTracker::recordAlloc(header->tag, size);
+
+        return header + 1;
+    }
+
+    void trackedFree(void* ptr) noexcept
+    {
+        if (!ptr)
+            return;
+
+        auto* header = static_cast<AllocationHeader*>(ptr) - 1;
+        RealmEngine::MemoryTracker::recordFree(header->tag, header->size);
+        std::free(header);
+    }
+
+    void* trackedAllocOrThrow(size_t size)
+    {
+        while (true)
+        {
+            if (void* ptr = trackedAlloc(size))
+                return ptr;
+
+            std::new_handler handler = std::get_new_handler();
+            if (!handler)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+} // namespace
+
+// aligned (align_val_t) overloads are left to the runtime, they never reach these
+void* operator new(size_t size) { return trackedAllocOrThrow(size); }
+void* operator new[](size_t size) { return trackedAllocOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedAlloc(size); }
+
+void operator delete(void* ptr) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { trackedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr); }
+#endif
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace RealmEngine
+{
+    enum class MemoryTag : uint8_t
+    {
+        General, // untagged, statics and third-party threads
+        Resource,
+        Render,
+        Logger,
+        UI,
+        Count,
+    };
+
+    /**
+     * @brief per-subsystem heap accounting, fed by the global operator new/delete replacement
+     *
+     * Only compiled in with REALM_MEMORY_TRACKING. Without it operator new is untouched,
+     * MEMORY_SCOPE expands to nothing and all stats read zero.
+     */
+    class MemoryTracker
+    {
+    public:
+        struct TagStats
+        {
+            size_t current_bytes {0};
+            size_t peak_bytes {0};
+            size_t total_allocations {0};
+            size_t live_allocations {0};
+        };
+
+        static constexpr bool isEnabled()
+        {
+#ifdef REALM_MEMORY_TRACKING
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        static const char* getTagName(MemoryTag tag);
+        static TagStats    getStats(MemoryTag tag);
+        // allocations ever made, all tags together
+        static size_t getTotalAllocations();
+
+        // log stats of every tag
+        static void dump();
+        // log subsystem tags still holding memory, call after subsystems are destroyed
+        static void reportLeaks();
+
+        static MemoryTag getCurrentTag();
+        static void      setCurrentTag(MemoryTag tag);
+
+        static void recordAlloc(MemoryTag tag, size_t bytes);
+        static void recordFree(MemoryTag tag, size_t bytes);
+    };
+
+#ifdef REALM_MEMORY_TRACKING
+    /**
+     * @brief allocations on this thread are charged to tag until the scope ends
+     */
+    class MemoryScope
+    {
+    public:
+        explicit MemoryScope(MemoryTag tag) : m_previous(MemoryTracker::getCurrentTag())
+        {
+            MemoryTracker::setCurrentTag(tag);
+        }
+        ~MemoryScope() { MemoryTracker::setCurrentTag(m_previous); }
+
+        MemoryScope(const MemoryScope&)            = delete;
+        MemoryScope& operator=(const MemoryScope&) = delete;
+
+    private:
+        MemoryTag m_previous;
+    };
+
+#define MEMORY_SCOPE(TAG) const ::RealmEngine::MemoryScope realm_memory_scope(TAG)
+#else
+#define MEMORY_SCOPE(TAG)
+#endif
+} // namespace RealmEngine
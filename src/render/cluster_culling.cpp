@@ -0,0 +1,89 @@
+#include "cluster_culling.h"
+#include "render/command_buffer.h"
+#include "resource/model.h"
+
+namespace RealmEngine
+{
+    ClusterCullView makeClusterCullView(const glm::mat4& view_projection,
+                                        const glm::mat4& model_matrix,
+                                        const glm::vec3& camera_position)
+    {
+        ClusterCullView view {};
+
+        // Gribb-Hartmann on the full mvp gives the planes directly in mesh space
+        glm::mat4 mvp = view_projection * model_matrix;
+        glm::vec4 row[4];
+        for (int r = 0; r < 4; ++r)
+            row[r] = glm::vec4(mvp[0][r], mvp[1][r], mvp[2][r], mvp[3][r]);
+
+        view.planes[0] = row[3] + row[0]; // left
+        view.planes[1] = row[3] - row[0]; // right
+        view.planes[2] = row[3] + row[1]; // bottom
+        view.planes[3] = row[3] - row[1]; // top
+        view.planes[4] = row[3] + row[2]; // near
+        view.planes[5] = row[3] - row[2]; // far
+
+        for (glm::vec4& plane : view.planes)
+        {
+            float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f)
+                plane /= length;
+        }
+
+        view.camera_position = glm::vec3(glm::inverse(model_matrix) * glm::vec4(camera_position, 1.0f));
+        return view;
+    }
+
+    bool isMeshletVisible(const Meshlet& meshlet, const ClusterCullView& view)
+    {
+        for (const glm::vec4& plane : view.planes)
+        {
+            if (glm::dot(glm::vec3(plane), meshlet.center) + plane.w < -meshlet.radius)
+                return false;
+        }
+
+        // every triangle faces away if the eye sits inside the cone's back side, widened by the sphere
+        glm::vec3 to_center = meshlet.center - view.camera_position;
+        return glm::dot(to_center, meshlet.cone_axis) <
+               meshlet.cone_cutoff * glm::length(to_center) + meshlet.radius;
+    }
+
+    bool recordVisibleMeshlets(CommandBuffer&         cmd,
+                               const Mesh&            mesh,
+                               const ClusterCullView& view,
+                               ClusterCullStats&      stats)
+    {
+        const auto& meshlets = mesh.getMeshlets();
+        if (meshlets.empty())
+            return false;
+
+        const size_t index_size = mesh.getIndexSize();
+
+        cmd.multiDrawElements(GL_TRIANGLES, mesh.getIndexType());
+
+        // open run of visible meshlets, flushed on the first culled one
+        uint32_t run_offset = 0;
+        uint32_t run_count  = 0;
+        for (const Meshlet& meshlet : meshlets)
+        {
+            ++stats.tested;
+            if (!isMeshletVisible(meshlet, view))
+            {
+                ++stats.culled;
+                if (run_count > 0)
+                    cmd.addDrawRange(run_count, static_cast<size_t>(run_offset) * index_size);
+                run_count = 0;
+                continue;
+            }
+
+            if (run_count == 0)
+                run_offset = meshlet.index_offset;
+            run_count += meshlet.index_count;
+        }
+
+        if (run_count > 0)
+            cmd.addDrawRange(run_count, static_cast<size_t>(run_offset) * index_size);
+
+        return true;
+    }
+} // namespace RealmEngine
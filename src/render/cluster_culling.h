@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+namespace RealmEngine
+{
+    class CommandBuffer;
+    class Mesh;
+    struct Meshlet;
+
+    /**
+     * @brief view volume and eye of one draw, moved into the mesh's own space
+     *
+     * Testing in mesh space keeps meshlet bounds untransformed, and backfacing is
+     * invariant under the model transform, so normal cones need no rotation either.
+     */
+    struct ClusterCullView
+    {
+        glm::vec4 planes[6]; // xyz normalized, inside where dot(xyz, p) + w >= 0
+        glm::vec3 camera_position;
+    };
+
+    // view_projection must be what the rasterizer sees (jittered), or edge clusters drop a pixel
+    ClusterCullView makeClusterCullView(const glm::mat4& view_projection,
+                                        const glm::mat4& model_matrix,
+                                        const glm::vec3& camera_position);
+
+    bool isMeshletVisible(const Meshlet& meshlet, const ClusterCullView& view);
+
+    struct ClusterCullStats
+    {
+        uint32_t tested {0};
+        uint32_t culled {0};
+    };
+
+    /**
+     * @brief record lod 0 of a meshlet mesh as one multi-draw of its visible meshlets
+     *
+     * Runs of consecutive visible meshlets are merged into one range. Returns false if
+     * the mesh has no meshlets, the caller then draws it whole.
+     */
+    bool recordVisibleMeshlets(CommandBuffer&         cmd,
+                               const Mesh&            mesh,
+                               const ClusterCullView& view,
+                               ClusterCullStats&      stats);
+} // namespace RealmEngine
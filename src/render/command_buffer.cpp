@@ -0,0 +1,119 @@
+#include "command_buffer.h"
+#include "render/state.h"
+
+namespace RealmEngine
+{
+    void CommandBuffer::reset()
+    {
+        // keep capacity, lists are refilled every frame
+        m_commands.clear();
+        m_matrices.clear();
+        m_vectors.clear();
+        m_draw_counts.clear();
+        m_draw_offsets.clear();
+    }
+
+    void CommandBuffer::useProgram(GLuint program)
+    {
+        m_commands.push_back({CommandType::UseProgram, {program, 0, 0, 0}});
+    }
+
+    void CommandBuffer::bindVAO(GLuint vao) { m_commands.push_back({CommandType::BindVAO, {vao, 0, 0, 0}}); }
+
+    void CommandBuffer::bindTexture(uint32_t unit, GLuint texture, GLenum target)
+    {
+        m_commands.push_back({CommandType::BindTexture, {unit, texture, target, 0}});
+    }
+
+    void CommandBuffer::setUniformInt(GLint location, int value)
+    {
+        if (location < 0)
+            return;
+
+        m_commands.push_back(
+            {CommandType::SetUniformInt, {static_cast<uint32_t>(location), static_cast<uint32_t>(value), 0, 0}});
+    }
+
+    void CommandBuffer::setUniformVec3(GLint location, const glm::vec3& value)
+    {
+        if (location < 0)
+            return;
+
+        auto index = static_cast<uint32_t>(m_vectors.size());
+        m_vectors.push_back(value);
+        m_commands.push_back({CommandType::SetUniformVec3, {static_cast<uint32_t>(location), index, 0, 0}});
+    }
+
+    void CommandBuffer::setUniformMat4(GLint location, const glm::mat4& value)
+    {
+        if (location < 0)
+            return;
+
+        auto index = static_cast<uint32_t>(m_matrices.size());
+        m_matrices.push_back(value);
+        m_commands.push_back({CommandType::SetUniformMat4, {static_cast<uint32_t>(location), index, 0, 0}});
+    }
+
+    void CommandBuffer::drawElements(GLenum mode, uint32_t count, GLenum index_type, size_t offset)
+    {
+        m_commands.push_back({CommandType::DrawElements, {mode, count, index_type, static_cast<uint32_t>(offset)}});
+    }
+
+    void CommandBuffer::multiDrawElements(GLenum mode, GLenum index_type)
+    {
+        auto first = static_cast<uint32_t>(m_draw_counts.size());
+        m_commands.push_back({CommandType::MultiDrawElements, {mode, index_type, first, 0}});
+    }
+
+    void CommandBuffer::addDrawRange(uint32_t count, size_t offset)
+    {
+        m_draw_counts.push_back(static_cast<GLsizei>(count));
+        m_draw_offsets.push_back(reinterpret_cast<const void*>(offset));
+        ++m_commands.back().args[3];
+    }
+
+    void CommandBuffer::submit(StateManager& state_mgr) const
+    {
+        for (const auto& command : m_commands)
+        {
+            const uint32_t* args = command.args;
+            switch (command.type)
+            {
+                case CommandType::UseProgram:
+                    glUseProgram(args[0]);
+                    break;
+                case CommandType::BindVAO:
+                    state_mgr.bindVAO(args[0]);
+                    break;
+                case CommandType::BindTexture:
+                    state_mgr.bindTexture(static_cast<int>(args[0]), args[1], args[2]);
+                    break;
+                case CommandType::SetUniformInt:
+                    glUniform1i(static_cast<GLint>(args[0]), static_cast<GLint>(args[1]));
+                    break;
+                case CommandType::SetUniformVec3:
+                    glUniform3fv(static_cast<GLint>(args[0]), 1, &m_vectors[args[1]][0]);
+                    break;
+                case CommandType::SetUniformMat4:
+                    glUniformMatrix4fv(static_cast<GLint>(args[0]), 1, GL_FALSE, &m_matrices[args[1]][0][0]);
+                    break;
+                case CommandType::DrawElements:
+                    glDrawElements(args[0],
+                                   static_cast<GLsizei>(args[1]),
+                                   args[2],
+                                   reinterpret_cast<const void*>(static_cast<uintptr_t>(args[3])));
+                    break;
+                case CommandType::MultiDrawElements:
+                    if (args[3] > 0)
+                    {
+                        glMultiDrawElements(args[0],
+                                            &m_draw_counts[args[2]],
+                                            args[1],
+                                            &m_draw_offsets[args[2]],
+                                            static_cast<GLsizei>(args[3]));
+                    }
+                    break;
+            }
+        }
+    }
+} // namespace RealmEngine
@@ -0,0 +1,72 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/gl.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace RealmEngine
+{
+    class StateManager;
+
+    /**
+     * @brief compact list of GL commands, recorded anywhere, replayed on the GL thread
+     *
+     * Recording never touches GL, so several lists can be filled by worker threads in parallel.
+     * Uniform locations must be resolved on the GL thread beforehand.
+     */
+    class CommandBuffer
+    {
+    public:
+        enum class CommandType : uint8_t
+        {
+            UseProgram,
+            BindVAO,
+            BindTexture,
+            SetUniformInt,
+            SetUniformVec3,
+            SetUniformMat4,
+            DrawElements,
+            MultiDrawElements,
+        };
+
+        void reset();
+
+        void useProgram(GLuint program);
+        void bindVAO(GLuint vao);
+        void bindTexture(uint32_t unit, GLuint texture, GLenum target = GL_TEXTURE_2D);
+        void setUniformInt(GLint location, int value);
+        void setUniformVec3(GLint location, const glm::vec3& value);
+        void setUniformMat4(GLint location, const glm::mat4& value);
+        void drawElements(GLenum mode, uint32_t count, GLenum index_type, size_t offset = 0);
+
+        // one glMultiDrawElements, ranges are appended with addDrawRange until the next command
+        void multiDrawElements(GLenum mode, GLenum index_type);
+        void addDrawRange(uint32_t count, size_t offset);
+
+        // must be called on the thread owning the GL context
+        void submit(StateManager& state_mgr) const;
+
+        size_t size() const { return m_commands.size(); }
+        bool   empty() const { return m_commands.empty(); }
+
+    private:
+        struct Command
+        {
+            CommandType type;
+            uint32_t    args[4];
+        };
+
+        std::vector<Command>   m_commands;
+        std::vector<glm::mat4> m_matrices; // payload of SetUniformMat4, referenced by index
+        std::vector<glm::vec3> m_vectors;  // payload of SetUniformVec3, referenced by index
+
+        // payload of MultiDrawElements, first range and range count in the command
+        std::vector<GLsizei>     m_draw_counts;
+        std::vector<const void*> m_draw_offsets;
+    };
+} // namespace RealmEngine
@@ -0,0 +1,109 @@
+#include "dynamic_resolution.h"
+#include "global.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace RealmEngine
+{
+    void DynamicResolution::initialize()
+    {
+        glGenQueries(m_QUERY_COUNT, m_queries.data());
+        m_query_pending.fill(false);
+        m_initialized = true;
+
+        LOG_INFO("DynamicResolution initialized");
+    }
+
+    void DynamicResolution::terminate()
+    {
+        if (m_initialized)
+            glDeleteQueries(m_QUERY_COUNT, m_queries.data());
+
+        m_initialized = false;
+        LOG_INFO("DynamicResolution terminated");
+    }
+
+    void DynamicResolution::setScaleRange(float min_scale, float max_scale)
+    {
+        m_min_scale = std::clamp(min_scale, 0.1f, 1.0f);
+        m_max_scale = std::clamp(max_scale, m_min_scale, 1.0f);
+        m_scale     = std::clamp(m_scale, m_min_scale, m_max_scale);
+    }
+
+    void DynamicResolution::beginFrame()
+    {
+        if (!m_initialized)
+            return;
+
+        collectResults();
+
+        // slot still in flight, skip measuring this frame rather than blocking on it
+        if (m_query_pending[m_frame_index])
+            return;
+
+        glBeginQuery(GL_TIME_ELAPSED, m_queries[m_frame_index]);
+    }
+
+    void DynamicResolution::endFrame()
+    {
+        if (!m_initialized || m_query_pending[m_frame_index])
+        {
+            m_frame_index = (m_frame_index + 1) % m_QUERY_COUNT;
+            return;
+        }
+
+        glEndQuery(GL_TIME_ELAPSED);
+        m_query_pending[m_frame_index] = true;
+        m_frame_index                  = (m_frame_index + 1) % m_QUERY_COUNT;
+    }
+
+    void DynamicResolution::collectResults()
+    {
+        // oldest first, stop at the first query the GPU has not finished
+        for (int i = 1; i <= m_QUERY_COUNT; ++i)
+        {
+            int slot = (m_frame_index + i) % m_QUERY_COUNT;
+            if (!m_query_pending[slot])
+                continue;
+
+            GLint available = 0;
+            glGetQueryObjectiv(m_queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+
+            GLuint64 elapsed_ns = 0;
+            glGetQueryObjectui64v(m_queries[slot], GL_QUERY_RESULT, &elapsed_ns);
+            m_query_pending[slot] = false;
+
+            updateScale(static_cast<float>(elapsed_ns) * 1e-6f);
+        }
+    }
+
+    void DynamicResolution::updateScale(float gpu_time_ms)
+    {
+        // exponential smoothing, single spikes should not change resolution
+        m_gpu_time_ms = m_gpu_time_ms == 0.0f ? gpu_time_ms : m_gpu_time_ms * 0.9f + gpu_time_ms * 0.1f;
+
+        if (!m_enabled || m_budget_ms <= 0.0f)
+            return;
+
+        // aim a bit below the hard budget to leave room for cpu-side variance
+        const float target = m_budget_ms * 0.9f;
+
+        if (m_gpu_time_ms > target)
+        {
+            // cost scales with pixel count, i.e. scale^2
+            float ratio = std::sqrt(target / m_gpu_time_ms);
+            m_scale *= std::max(ratio, 0.9f);
+        }
+        else if (m_gpu_time_ms < target * 0.8f)
+        {
+            // grow slowly to avoid oscillating around the budget
+            m_scale += 0.01f;
+        }
+
+        m_scale = std::clamp(m_scale, m_min_scale, m_max_scale);
+    }
+} // namespace RealmEngine
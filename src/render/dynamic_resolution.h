@@ -0,0 +1,56 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/gl.h>
+
+#include <array>
+
+namespace RealmEngine
+{
+    /**
+     * @brief picks the internal render scale from measured GPU frame time
+     *
+     * GPU time is measured with GL_TIME_ELAPSED queries kept in a small ring, so
+     * results are read a few frames late and never stall the pipeline.
+     */
+    class DynamicResolution
+    {
+    public:
+        static constexpr float m_DEFAULT_MIN_SCALE = 0.5f;
+        static constexpr float m_DEFAULT_MAX_SCALE = 1.0f;
+
+        void initialize();
+        void terminate();
+
+        void beginFrame();
+        void endFrame();
+
+        void  setFrameTimeBudget(float budget_ms) { m_budget_ms = budget_ms; }
+        float getFrameTimeBudget() const { return m_budget_ms; }
+        void  setEnabled(bool enabled) { m_enabled = enabled; }
+        bool  isEnabled() const { return m_enabled; }
+        void  setScaleRange(float min_scale, float max_scale);
+
+        float getScale() const { return m_enabled && m_budget_ms > 0.0f ? m_scale : m_max_scale; }
+        float getGPUTime() const { return m_gpu_time_ms; }
+
+    private:
+        static constexpr int m_QUERY_COUNT = 4;
+
+        std::array<GLuint, m_QUERY_COUNT> m_queries {};
+        std::array<bool, m_QUERY_COUNT>   m_query_pending {};
+        int                               m_frame_index {0};
+        bool                              m_initialized {false};
+
+        bool  m_enabled {true};
+        float m_budget_ms {16.6f};
+        float m_min_scale {m_DEFAULT_MIN_SCALE};
+        float m_max_scale {m_DEFAULT_MAX_SCALE};
+        float m_scale {m_DEFAULT_MAX_SCALE};
+        float m_gpu_time_ms {0.0f};
+
+        void collectResults();
+        void updateScale(float gpu_time_ms);
+    };
+} // namespace RealmEngine
@@ -0,0 +1,136 @@
+#include "frame_pacer.h"
+#include "global.h"
+#include "logger.h"
+#include "render/window.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace RealmEngine
+{
+    void FramePacer::initialize(Window* window)
+    {
+        m_window = window;
+
+        if (m_window)
+        {
+            m_adaptive_supported = glfwExtensionSupported("GLX_EXT_swap_control_tear") == GLFW_TRUE ||
+                                   glfwExtensionSupported("WGL_EXT_swap_control_tear") == GLFW_TRUE;
+        }
+
+        applySwapMode();
+
+        m_last_frame    = Clock::now();
+        m_next_deadline = m_last_frame;
+
+        LOG_INFO("FramePacer initialized");
+    }
+
+    void FramePacer::terminate()
+    {
+        m_window = nullptr;
+        LOG_INFO("FramePacer terminated");
+    }
+
+    void FramePacer::setSwapMode(SwapMode mode)
+    {
+        m_swap_mode = mode;
+        applySwapMode();
+    }
+
+    void FramePacer::setTargetFPS(float fps)
+    {
+        m_target_fps    = std::max(fps, 0.0f);
+        m_next_deadline = Clock::now();
+    }
+
+    void FramePacer::endFrame()
+    {
+        waitForDeadline();
+
+        Clock::time_point now      = Clock::now();
+        float             frame_ms = std::chrono::duration<float, std::milli>(now - m_last_frame).count();
+        m_last_frame               = now;
+
+        recordFrameTime(frame_ms);
+    }
+
+    void FramePacer::applySwapMode()
+    {
+        if (!m_window)
+            return;
+
+        switch (m_swap_mode)
+        {
+            case SwapMode::Immediate:
+                m_window->setSwapInterval(0);
+                break;
+            case SwapMode::VSync:
+                m_window->setSwapInterval(1);
+                break;
+            case SwapMode::Adaptive:
+                // negative interval means tear-on-late, only valid with the tear extension
+                m_window->setSwapInterval(m_adaptive_supported ? -1 : 1);
+                break;
+        }
+    }
+
+    void FramePacer::waitForDeadline()
+    {
+        if (m_target_fps <= 0.0f)
+            return;
+
+        using Seconds = std::chrono::duration<double>;
+
+        m_next_deadline += std::chrono::duration_cast<Clock::duration>(Seconds(1.0 / m_target_fps));
+
+        // a frame ran long: restart the schedule instead of rushing the following frames
+        Clock::time_point now = Clock::now();
+        if (now > m_next_deadline)
+        {
+            m_next_deadline = now;
+            return;
+        }
+
+        const auto spin_window = std::chrono::duration_cast<Clock::duration>(Seconds(m_SPIN_WINDOW));
+        if (m_next_deadline - now > spin_window)
+            std::this_thread::sleep_for(m_next_deadline - now - spin_window);
+
+        while (Clock::now() < m_next_deadline)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    void FramePacer::recordFrameTime(float frame_ms)
+    {
+        m_frame_times[m_history_index] = frame_ms;
+        m_history_index                = (m_history_index + 1) % m_HISTORY_SIZE;
+        m_history_count                = std::min(m_history_count + 1, m_HISTORY_SIZE);
+
+        float sum    = 0.0f;
+        float min_ms = m_frame_times[0];
+        float max_ms = m_frame_times[0];
+        for (int i = 0; i < m_history_count; ++i)
+        {
+            sum += m_frame_times[i];
+            min_ms = std::min(min_ms, m_frame_times[i]);
+            max_ms = std::max(max_ms, m_frame_times[i]);
+        }
+        float average = sum / static_cast<float>(m_history_count);
+
+        float variance = 0.0f;
+        for (int i = 0; i < m_history_count; ++i)
+        {
+            float diff = m_frame_times[i] - average;
+            variance += diff * diff;
+        }
+        variance /= static_cast<float>(m_history_count);
+
+        m_stats.average_ms = average;
+        m_stats.stddev_ms  = std::sqrt(variance);
+        m_stats.min_ms     = min_ms;
+        m_stats.max_ms     = max_ms;
+    }
+} // namespace RealmEngine
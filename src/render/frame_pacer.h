@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+
+namespace RealmEngine
+{
+    class Window;
+
+    enum class SwapMode : uint8_t
+    {
+        Immediate, // no v-sync, may tear
+        VSync,
+        Adaptive, // v-sync, but late frames tear instead of waiting (EXT_swap_control_tear)
+    };
+
+    /**
+     * @brief owns swap interval and frame timing: optional fps cap and frame-time statistics
+     *
+     * The limiter sleeps until shortly before the deadline and spins the rest, OS sleep granularity
+     * alone is too coarse for stable pacing. Works without a window (headless runs).
+     */
+    class FramePacer
+    {
+    public:
+        struct Stats
+        {
+            float average_ms {0.0f};
+            float stddev_ms {0.0f}; // frame-to-frame consistency, lower is smoother
+            float min_ms {0.0f};
+            float max_ms {0.0f};
+        };
+
+        void initialize(Window* window);
+        void terminate();
+
+        // call right after present, blocks until the next frame may start
+        void endFrame();
+
+        void     setSwapMode(SwapMode mode);
+        SwapMode getSwapMode() const { return m_swap_mode; }
+        bool     isAdaptiveSupported() const { return m_adaptive_supported; }
+
+        // <= 0 disables the limiter
+        void  setTargetFPS(float fps);
+        float getTargetFPS() const { return m_target_fps; }
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr int    m_HISTORY_SIZE = 120;
+        static constexpr double m_SPIN_WINDOW  = 0.002; // seconds left to spin after sleeping
+
+        Window*  m_window {nullptr};
+        SwapMode m_swap_mode {SwapMode::VSync};
+        bool     m_adaptive_supported {false};
+        float    m_target_fps {0.0f};
+
+        Clock::time_point m_last_frame;
+        Clock::time_point m_next_deadline;
+
+        std::array<float, m_HISTORY_SIZE> m_frame_times {};
+        int                               m_history_count {0};
+        int                               m_history_index {0};
+        Stats                             m_stats;
+
+        void applySwapMode();
+        void waitForDeadline();
+        void recordFrameTime(float frame_ms);
+    };
+} // namespace RealmEngine
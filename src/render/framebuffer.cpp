@@ -1,11 +1,25 @@
 #include "framebuffer.h"
 #include "global.h"
 
+#include <algorithm>
+#include <string>
+#include <utility>
+
 namespace RealmEngine
 {
     bool FramebufferManager::initialize(int width, int height)
     {
-        resize(width, height);
+        m_width        = width;
+        m_height       = height;
+        m_alloc_width  = bucketSize(width);
+        m_alloc_height = bucketSize(height);
+        updateRenderRegion();
+
+        // shadow maps have a fixed size and are never rebuilt on resize
+        createShadowMaps();
+        createGBuffer();
+        createPostProcessBuffers();
+        createTemporalBuffers();
 
         LOG_INFO("FramebufferManager initialized");
         return true;
@@ -14,16 +28,7 @@ namespace RealmEngine
     void FramebufferManager::terminate()
     {
         for (auto& [type, data] : m_framebuffers)
-        {
-            if (data.fbo != 0)
-                glDeleteFramebuffers(1, &data.fbo);
-
-            for (auto& [attachment, texture] : data.attachments)
-            {
-                if (texture != 0)
-                    glDeleteTextures(1, &texture);
-            }
-        }
+            destroyFramebuffer(data);
 
         m_framebuffers.clear();
         LOG_INFO("FramebufferManager terminated");
@@ -34,8 +39,20 @@ namespace RealmEngine
         auto it = m_framebuffers.find(type);
         if (it != m_framebuffers.end())
         {
-            glBindFramebuffer(GL_FRAMEBUFFER, it->second.fbo);
-            glViewport(0, 0, it->second.width, it->second.height);
+            const FramebufferData& data = it->second;
+            glBindFramebuffer(GL_FRAMEBUFFER, data.fbo);
+            glViewport(0, 0, data.width, data.height);
+
+            // textures may be over-allocated, keep clears inside the used region
+            if (data.width != data.alloc_width || data.height != data.alloc_height)
+            {
+                glEnable(GL_SCISSOR_TEST);
+                glScissor(0, 0, data.width, data.height);
+            }
+            else
+            {
+                glDisable(GL_SCISSOR_TEST);
+            }
         }
     }
 
@@ -43,6 +60,7 @@ namespace RealmEngine
     {
         glBindFramebuffer(GL_FRAMEBUFFER, 0);
         glViewport(0, 0, m_width, m_height);
+        glDisable(GL_SCISSOR_TEST);
     }
 
     void FramebufferManager::bindAttachment(AttachmentType attachment, int textureUnit)
@@ -66,34 +84,179 @@ namespace RealmEngine
         return 0;
     }
 
+    /**
+     * @brief resize all size-dependent framebuffers
+     *
+     * Textures are allocated in buckets of m_RESIZE_BUCKET pixels, a resize that stays
+     * inside the current bucket only shrinks/grows the used region and allocates nothing.
+     *
+     * @param width new framebuffer width
+     * @param height new framebuffer height
+     */
     void FramebufferManager::resize(int width, int height)
     {
+        // minimized window, keep what we have
+        if (width <= 0 || height <= 0)
+            return;
+
         if (m_width == width && m_height == height)
             return;
 
-        // clean all framebuffers
-        for (auto& [type, data] : m_framebuffers)
-        {
-            if (data.fbo != 0)
-                glDeleteFramebuffers(1, &data.fbo);
-
-            for (auto& [attachment, texture] : data.attachments)
-            {
-                if (texture != 0)
-                    glDeleteTextures(1, &texture);
-            }
-        }
+        const bool realloc = needsReallocation(width, height);
 
         // set new width and height
         m_width  = width;
         m_height = height;
 
+        if (!realloc)
+        {
+            updateRenderRegion();
+            return;
+        }
+
+        destroySizeDependentBuffers();
+
+        m_alloc_width  = bucketSize(width);
+        m_alloc_height = bucketSize(height);
+        updateRenderRegion();
+
         // re-create framebuffers we need
         createGBuffer();
-        createShadowMaps();
         createPostProcessBuffers();
+        createTemporalBuffers();
+        ++m_generation;
 
-        m_framebuffers.clear();
+        LOG_INFO("Framebuffers reallocated to " + std::to_string(m_alloc_width) + "x" +
+                 std::to_string(m_alloc_height));
+    }
+
+    bool FramebufferManager::needsReallocation(int width, int height) const
+    {
+        return bucketSize(width) != m_alloc_width || bucketSize(height) != m_alloc_height;
+    }
+
+    glm::vec2 FramebufferManager::getUVScale(FramebufferType type) const
+    {
+        auto it = m_framebuffers.find(type);
+        if (it == m_framebuffers.end() || it->second.alloc_width == 0 || it->second.alloc_height == 0)
+            return glm::vec2(1.0f);
+
+        return glm::vec2(static_cast<float>(it->second.width) / static_cast<float>(it->second.alloc_width),
+                         static_cast<float>(it->second.height) / static_cast<float>(it->second.alloc_height));
+    }
+
+    /**
+     * @brief set the internal resolution of size-dependent targets relative to the output size
+     *
+     * The scale only shrinks the used region of the existing allocation, so changing it
+     * every frame is free.
+     *
+     * @param scale internal / output resolution, (0, 1]
+     */
+    void FramebufferManager::setRenderScale(float scale)
+    {
+        scale = std::clamp(scale, 0.1f, 1.0f);
+        if (scale == m_render_scale)
+            return;
+
+        m_render_scale = scale;
+        updateRenderRegion();
+    }
+
+    void FramebufferManager::updateRenderRegion()
+    {
+        int width  = static_cast<int>(static_cast<float>(m_width) * m_render_scale);
+        int height = static_cast<int>(static_cast<float>(m_height) * m_render_scale);
+
+        m_render_width  = std::clamp(width, 1, m_alloc_width);
+        m_render_height = std::clamp(height, 1, m_alloc_height);
+
+        for (auto& [type, data] : m_framebuffers)
+        {
+            if (!data.size_dependent)
+                continue;
+            data.width  = data.output_sized ? m_width : m_render_width;
+            data.height = data.output_sized ? m_height : m_render_height;
+        }
+    }
+
+    /**
+     * @brief upscale the used region of a framebuffer's first color attachment to the default framebuffer
+     */
+    void FramebufferManager::blitToDefault(FramebufferType type)
+    {
+        auto it = m_framebuffers.find(type);
+        if (it == m_framebuffers.end())
+            return;
+
+        const FramebufferData& data = it->second;
+
+        // blits are clipped by the scissor box
+        glDisable(GL_SCISSOR_TEST);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, data.fbo);
+        glReadBuffer(GL_COLOR_ATTACHMENT0);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+        glBlitFramebuffer(0, 0, data.width, data.height, 0, 0, m_width, m_height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+        bindDefaultFrameBuffer();
+    }
+
+    /**
+     * @brief switch the gbuffer attachment formats, the gbuffer is recreated in place
+     *
+     * Passes reading/writing the gbuffer must use the matching shader variant (GBUFFER_COMPACT).
+     */
+    void FramebufferManager::setGBufferLayout(GBufferLayout layout)
+    {
+        if (m_gbuffer_layout == layout)
+            return;
+
+        m_gbuffer_layout = layout;
+
+        auto it = m_framebuffers.find(FramebufferType::GBuffer);
+        if (it != m_framebuffers.end())
+        {
+            destroyFramebuffer(it->second);
+            m_framebuffers.erase(it);
+            createGBuffer();
+            ++m_generation;
+        }
+    }
+
+    int FramebufferManager::bucketSize(int size)
+    {
+        return ((std::max(size, 1) + m_RESIZE_BUCKET - 1) / m_RESIZE_BUCKET) * m_RESIZE_BUCKET;
+    }
+
+    void FramebufferManager::destroyFramebuffer(FramebufferData& data)
+    {
+        if (data.fbo != 0)
+            glDeleteFramebuffers(1, &data.fbo);
+
+        for (auto& [attachment, texture] : data.attachments)
+        {
+            if (texture != 0)
+                glDeleteTextures(1, &texture);
+        }
+
+        data.fbo = 0;
+        data.attachments.clear();
+    }
+
+    void FramebufferManager::destroySizeDependentBuffers()
+    {
+        for (auto it = m_framebuffers.begin(); it != m_framebuffers.end();)
+        {
+            if (it->second.size_dependent)
+            {
+                destroyFramebuffer(it->second);
+                it = m_framebuffers.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
     }
 
     void FramebufferManager::clearFrameBuffer(FramebufferType type, bool color, bool depth, bool stencil)
@@ -115,30 +278,38 @@ namespace RealmEngine
     void FramebufferManager::createGBuffer()
     {
         FramebufferData g_buffer;
-        g_buffer.width  = m_width;
-        g_buffer.height = m_height;
+        g_buffer.width        = m_render_width;
+        g_buffer.height       = m_render_height;
+        g_buffer.alloc_width  = m_alloc_width;
+        g_buffer.alloc_height = m_alloc_height;
 
         glGenFramebuffers(1, &g_buffer.fbo);
         glBindFramebuffer(GL_FRAMEBUFFER, g_buffer.fbo);
 
         // Albedo + Metallic (RGBA8)
-        g_buffer.attachments[AttachmentType::GBuffer_Albedo] = createColorTexture(m_width, m_height, GL_RGBA8);
+        g_buffer.attachments[AttachmentType::GBuffer_Albedo] =
+            createColorTexture(m_alloc_width, m_alloc_height, GL_RGBA8);
         glFramebufferTexture2D(GL_FRAMEBUFFER,
                                GL_COLOR_ATTACHMENT0,
                                GL_TEXTURE_2D,
                                g_buffer.attachments[AttachmentType::GBuffer_Albedo],
                                0);
 
-        // Normal + Roughness (RGBA16F)
-        g_buffer.attachments[AttachmentType::GBuffer_Normal] = createColorTexture(m_width, m_height, GL_RGBA16F);
+        // Standard: Normal + Roughness (RGBA16F)
+        // Compact:  Octahedral normal + Roughness + Shading Model ID (RGB10A2)
+        const bool compact = m_gbuffer_layout == GBufferLayout::Compact;
+        g_buffer.attachments[AttachmentType::GBuffer_Normal] =
+            createColorTexture(m_alloc_width, m_alloc_height, compact ? GL_RGB10_A2 : GL_RGBA16F);
         glFramebufferTexture2D(GL_FRAMEBUFFER,
                                GL_COLOR_ATTACHMENT1,
                                GL_TEXTURE_2D,
                                g_buffer.attachments[AttachmentType::GBuffer_Normal],
                                0);
 
-        // Motion + Shading Model ID (RGBA8)
-        g_buffer.attachments[AttachmentType::GBuffer_Motion] = createColorTexture(m_width, m_height, GL_RGBA8);
+        // Standard: Motion + Shading Model ID (RGBA16F, motion vectors are signed)
+        // Compact:  Motion (RG16F)
+        g_buffer.attachments[AttachmentType::GBuffer_Motion] =
+            createColorTexture(m_alloc_width, m_alloc_height, compact ? GL_RG16F : GL_RGBA16F);
         glFramebufferTexture2D(GL_FRAMEBUFFER,
                                GL_COLOR_ATTACHMENT2,
                                GL_TEXTURE_2D,
@@ -146,7 +317,7 @@ namespace RealmEngine
                                0);
 
         // Depth buffer
-        g_buffer.attachments[AttachmentType::GBuffer_Depth] = createDepthTexture(m_width, m_height);
+        g_buffer.attachments[AttachmentType::GBuffer_Depth] = createDepthTexture(m_alloc_width, m_alloc_height);
         glFramebufferTexture2D(
             GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, g_buffer.attachments[AttachmentType::GBuffer_Depth], 0);
 
@@ -167,8 +338,11 @@ namespace RealmEngine
     {
         // Directional shadow map
         FramebufferData shadow_map;
-        shadow_map.width  = 2048;
-        shadow_map.height = 2048;
+        shadow_map.width          = 2048;
+        shadow_map.height         = 2048;
+        shadow_map.alloc_width    = shadow_map.width;
+        shadow_map.alloc_height   = shadow_map.height;
+        shadow_map.size_dependent = false;
 
         glGenFramebuffers(1, &shadow_map.fbo);
         glBindFramebuffer(GL_FRAMEBUFFER, shadow_map.fbo);
@@ -196,13 +370,16 @@ namespace RealmEngine
     {
         // Post process buffer A
         FramebufferData post_process_a;
-        post_process_a.width  = m_width;
-        post_process_a.height = m_height;
+        post_process_a.width        = m_render_width;
+        post_process_a.height       = m_render_height;
+        post_process_a.alloc_width  = m_alloc_width;
+        post_process_a.alloc_height = m_alloc_height;
 
         glGenFramebuffers(1, &post_process_a.fbo);
         glBindFramebuffer(GL_FRAMEBUFFER, post_process_a.fbo);
 
-        post_process_a.attachments[AttachmentType::HDR_Color] = createColorTexture(m_width, m_height, GL_RGBA16F);
+        post_process_a.attachments[AttachmentType::HDR_Color] =
+            createColorTexture(m_alloc_width, m_alloc_height, GL_RGBA16F, GL_LINEAR);
         glFramebufferTexture2D(GL_FRAMEBUFFER,
                                GL_COLOR_ATTACHMENT0,
                                GL_TEXTURE_2D,
@@ -217,11 +394,16 @@ namespace RealmEngine
         m_framebuffers[FramebufferType::PostProcess_A] = post_process_a;
 
         // Post process buffer B (similar structure)
-        FramebufferData post_process_b = post_process_a;
+        FramebufferData post_process_b;
+        post_process_b.width        = m_render_width;
+        post_process_b.height       = m_render_height;
+        post_process_b.alloc_width  = m_alloc_width;
+        post_process_b.alloc_height = m_alloc_height;
         glGenFramebuffers(1, &post_process_b.fbo);
         glBindFramebuffer(GL_FRAMEBUFFER, post_process_b.fbo);
 
-        post_process_b.attachments[AttachmentType::LDR_Color] = createColorTexture(m_width, m_height, GL_RGBA8);
+        post_process_b.attachments[AttachmentType::LDR_Color] =
+            createColorTexture(m_alloc_width, m_alloc_height, GL_RGBA8);
         glFramebufferTexture2D(GL_FRAMEBUFFER,
                                GL_COLOR_ATTACHMENT0,
                                GL_TEXTURE_2D,
@@ -237,19 +419,60 @@ namespace RealmEngine
         LOG_INFO("Post process buffers created");
     }
 
-    GLuint FramebufferManager::createColorTexture(int width, int height, GLenum internalFormat)
+    void FramebufferManager::createTemporalBuffers()
+    {
+        // TAA history ping-pong, kept at output resolution so TAA can also upsample
+        const std::pair<FramebufferType, AttachmentType> history[] = {
+            {FramebufferType::TemporalHistory_A, AttachmentType::History_A},
+            {FramebufferType::TemporalHistory_B, AttachmentType::History_B},
+        };
+
+        for (const auto& [type, attachment] : history)
+        {
+            FramebufferData temporal;
+            temporal.width        = m_width;
+            temporal.height       = m_height;
+            temporal.alloc_width  = m_alloc_width;
+            temporal.alloc_height = m_alloc_height;
+            temporal.output_sized = true;
+
+            glGenFramebuffers(1, &temporal.fbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, temporal.fbo);
+
+            temporal.attachments[attachment] =
+                createColorTexture(m_alloc_width, m_alloc_height, GL_RGBA16F, GL_LINEAR);
+            glFramebufferTexture2D(
+                GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, temporal.attachments[attachment], 0);
+
+            if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+            {
+                LOG_ERROR("Temporal history framebuffer not complete!");
+            }
+
+            m_framebuffers[type] = temporal;
+        }
+
+        LOG_INFO("Temporal history buffers created");
+    }
+
+    GLuint FramebufferManager::createColorTexture(int width, int height, GLenum internalFormat, GLenum filter)
     {
         GLuint texture;
         glGenTextures(1, &texture);
         glBindTexture(GL_TEXTURE_2D, texture);
 
-        GLenum format = (internalFormat == GL_RGBA8 || internalFormat == GL_RGBA16F) ? GL_RGBA : GL_RGB;
-        GLenum type   = (internalFormat == GL_RGBA16F) ? GL_FLOAT : GL_UNSIGNED_BYTE;
+        GLenum format = GL_RGB;
+        if (internalFormat == GL_RGBA8 || internalFormat == GL_RGBA16F || internalFormat == GL_RGB10_A2)
+            format = GL_RGBA;
+        else if (internalFormat == GL_RG16F || internalFormat == GL_RG16)
+            format = GL_RG;
+
+        GLenum type = (internalFormat == GL_RGBA16F || internalFormat == GL_RG16F) ? GL_FLOAT : GL_UNSIGNED_BYTE;
 
         glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, type, nullptr);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
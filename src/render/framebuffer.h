@@ -4,6 +4,8 @@
 #include <GLFW/glfw3.h>
 #include <glad/gl.h>
 
+#include <cstdint>
+#include <glm/glm.hpp>
 #include <map>
 
 namespace RealmEngine
@@ -15,9 +17,12 @@ namespace RealmEngine
         GBuffer,              // GBuffer
         PostProcess_A,        // 后处理A(ping-pong缓冲区)
         PostProcess_B,        // 后处理B
+        TemporalHistory_A,    // TAA历史帧A(ping-pong, 输出分辨率)
+        TemporalHistory_B,    // TAA历史帧B
         Default,              // glfw默认
     };
 
+    // formats below are GBufferLayout::Standard, see GBufferLayout for the compact packing
     enum class AttachmentType : uint8_t
     {
         GBuffer_Albedo, // RGB: 反照率, A: 金属度
@@ -27,6 +32,14 @@ namespace RealmEngine
         HDR_Color,      // HDR颜色缓冲,后处理
         LDR_Color,      // LDR颜色缓冲,后处理
         Shadow_Depth,   // 阴影深度
+        History_A,      // TAA历史颜色A
+        History_B,      // TAA历史颜色B
+    };
+
+    enum class GBufferLayout : uint8_t
+    {
+        Standard, // RGBA8 albedo, RGBA16F normal, RGBA16F motion
+        Compact,  // RGBA8 albedo, RGB10A2 octahedral normal + roughness + shading model, RG16F motion
     };
 
     class FramebufferManager
@@ -41,28 +54,66 @@ namespace RealmEngine
         void   bindAttachment(AttachmentType attachment, int textureUnit);
         GLuint getAttachment(AttachmentType attachment);
 
-        void resize(int width, int height);
+        void      resize(int width, int height);
+        bool      needsReallocation(int width, int height) const;
+        glm::vec2 getUVScale(FramebufferType type) const;
+        int       getWidth() const { return m_width; }
+        int       getHeight() const { return m_height; }
+        uint32_t  getGeneration() const { return m_generation; }
+
+        void  setRenderScale(float scale);
+        float getRenderScale() const { return m_render_scale; }
+        int   getRenderWidth() const { return m_render_width; }
+        int   getRenderHeight() const { return m_render_height; }
+
+        void blitToDefault(FramebufferType type);
+
+        void          setGBufferLayout(GBufferLayout layout);
+        GBufferLayout getGBufferLayout() const { return m_gbuffer_layout; }
 
         void clearFrameBuffer(FramebufferType type, bool color = true, bool depth = true, bool stencil = false);
 
+        // size-dependent textures are allocated rounded up to this granularity,
+        // so resizing inside a bucket only moves the viewport
+        static constexpr int m_RESIZE_BUCKET = 256;
+
     private:
         struct FramebufferData
         {
             GLuint                           fbo {0};
             std::map<AttachmentType, GLuint> attachments;
-            int                              width {0};
-            int                              height {0};
+            int                              width {0};        // used region (viewport)
+            int                              height {0};       // used region (viewport)
+            int                              alloc_width {0};  // allocated texture size
+            int                              alloc_height {0}; // allocated texture size
+            bool                             size_dependent {true};
+            bool                             output_sized {false}; // follows output size, not render scale
         };
 
         std::map<FramebufferType, FramebufferData> m_framebuffers;
         int                                        m_width {0};
         int                                        m_height {0};
+        int                                        m_alloc_width {0};
+        int                                        m_alloc_height {0};
+        float                                      m_render_scale {1.0f};
+        int                                        m_render_width {0};
+        int                                        m_render_height {0};
+        uint32_t                                   m_generation {0}; // bumped on every reallocation
+        GBufferLayout                              m_gbuffer_layout {GBufferLayout::Standard};
+
+        static int bucketSize(int size);
+
+        void updateRenderRegion();
+
+        void destroyFramebuffer(FramebufferData& data);
+        void destroySizeDependentBuffers();
 
         void createGBuffer();
         void createShadowMaps();
         void createPostProcessBuffers();
+        void createTemporalBuffers();
 
-        GLuint createColorTexture(int width, int height, GLenum internalFormat);
+        GLuint createColorTexture(int width, int height, GLenum internalFormat, GLenum filter = GL_NEAREST);
         GLuint createDepthTexture(int width, int height);
         GLuint createCubeMapTexture(int size);
     };
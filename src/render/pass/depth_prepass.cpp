@@ -0,0 +1,184 @@
+#include "depth_prepass.h"
+#include "global.h"
+#include "logger.h"
+#include "render/framebuffer.h"
+#include "render/state.h"
+#include "resource/model.h"
+#include "resource/shader.h"
+
+namespace RealmEngine
+{
+    DepthPrePass::DepthPrePass(FramebufferManager* fb_mgr, StateManager* state_mgr) :
+        m_framebuffer_mgr(fb_mgr), m_state_mgr(state_mgr)
+    {
+        m_format_shaders[static_cast<size_t>(VertexFormat::Float32)] =
+            std::make_shared<Shader>("shader/depth_prepass.vert", "shader/depth_prepass.frag");
+        m_format_shaders[static_cast<size_t>(VertexFormat::Compressed)] =
+            std::make_shared<Shader>("shader/depth_prepass.vert",
+                                     "shader/depth_prepass.frag",
+                                     std::vector<std::string> {"VERTEX_COMPRESSED"});
+        m_shader = m_format_shaders[static_cast<size_t>(VertexFormat::Float32)];
+
+        // per-object uniforms, resolved once instead of by name in the draw loop
+        for (size_t format = 0; format < g_vertex_format_count; ++format)
+        {
+            UniformLocations& locations = m_locations[format];
+            locations.model             = m_format_shaders[format]->getUniformLocation("model");
+            locations.position_scale    = m_format_shaders[format]->getUniformLocation("positionScale");
+            locations.position_offset   = m_format_shaders[format]->getUniformLocation("positionOffset");
+        }
+
+        glGenQueries(m_QUERY_COUNT, m_queries.data());
+
+        StateManager::State prepass_state;
+        prepass_state.enable_depth_test = true;
+        prepass_state.depth_func        = GL_LESS;
+        prepass_state.depth_write       = true;
+        prepass_state.color_write       = false;
+        prepass_state.enable_culling    = true;
+        prepass_state.cull_face         = GL_BACK;
+        prepass_state.blending          = false;
+
+        if (m_state_mgr)
+            m_pipeline_state = m_state_mgr->createPipelineState(prepass_state);
+    }
+
+    DepthPrePass::~DepthPrePass() { glDeleteQueries(m_QUERY_COUNT, m_queries.data()); }
+
+    bool DepthPrePass::isActive() const
+    {
+        switch (m_mode)
+        {
+            case DepthPrePassMode::Off:
+                return false;
+            case DepthPrePassMode::On:
+                return true;
+            case DepthPrePassMode::Auto:
+                return m_auto_active;
+        }
+        return false;
+    }
+
+    bool DepthPrePass::prepare()
+    {
+        if (!m_shader || !m_framebuffer_mgr || !m_state_mgr || !m_render_objects || !m_draw_order)
+        {
+            LOG_ERROR("DepthPrePass not properly initialized");
+            return false;
+        }
+
+        // the pre-pass owns the gbuffer clear, the gbuffer pass then only shades
+        m_framebuffer_mgr->bindFrameBuffer(FramebufferType::GBuffer);
+        m_framebuffer_mgr->clearFrameBuffer(FramebufferType::GBuffer);
+
+        m_state_mgr->bindPipelineState(m_pipeline_state);
+
+        for (const auto& shader : m_format_shaders)
+        {
+            shader->use();
+            shader->setMat4("view", m_view_matrix);
+            shader->setMat4("projection", m_projection_matrix);
+            shader->setVec2("jitter", m_jitter);
+        }
+
+        return true;
+    }
+
+    void DepthPrePass::draw()
+    {
+        if (!prepare())
+            return;
+
+        // draw order is sorted by vertex format, so programs switch at most once per format
+        Shader* current = nullptr;
+        for (uint32_t index : *m_draw_order)
+        {
+            const RenderObject& obj = (*m_render_objects)[index];
+            if (!obj.model)
+                continue;
+
+            size_t  format = static_cast<size_t>(obj.model->getVertexFormat());
+            Shader* shader = m_format_shaders[format].get();
+            if (shader != current)
+            {
+                shader->use();
+                current = shader;
+            }
+
+            const UniformLocations& locations = m_locations[format];
+            glUniformMatrix4fv(locations.model, 1, GL_FALSE, &obj.model_matrix[0][0]);
+            for (const auto& mesh : obj.model->getMeshes())
+            {
+                if (mesh.getVertexFormat() == VertexFormat::Compressed)
+                {
+                    glm::vec3 scale  = mesh.getPositionScale();
+                    glm::vec3 offset = mesh.getPositionOffset();
+                    glUniform3f(locations.position_scale, scale.x, scale.y, scale.z);
+                    glUniform3f(locations.position_offset, offset.x, offset.y, offset.z);
+                }
+
+                // same lod as the gbuffer pass, the GL_EQUAL depth test needs identical triangles
+                m_state_mgr->bindVAO(mesh.getVAO());
+                glDrawElements(GL_TRIANGLES,
+                               static_cast<GLsizei>(mesh.getIndexCount(obj.lod)),
+                               mesh.getIndexType(),
+                               reinterpret_cast<void*>(mesh.getIndexByteOffset(obj.lod)));
+            }
+        }
+
+        clean();
+    }
+
+    void DepthPrePass::clean()
+    {
+        m_state_mgr->unbindVAO();
+    }
+
+    void DepthPrePass::beginMeasure()
+    {
+        collectResults();
+
+        // previous query in this slot not resolved yet, skip measuring this frame
+        if (m_mode != DepthPrePassMode::Auto || m_query_pixels[m_query_index] != 0)
+            return;
+
+        glBeginQuery(GL_SAMPLES_PASSED, m_queries[m_query_index]);
+        m_measuring = true;
+    }
+
+    void DepthPrePass::endMeasure()
+    {
+        if (!m_measuring)
+            return;
+
+        glEndQuery(GL_SAMPLES_PASSED);
+        m_query_pixels[m_query_index] = m_framebuffer_mgr->getRenderWidth() * m_framebuffer_mgr->getRenderHeight();
+        m_query_index                 = (m_query_index + 1) % m_QUERY_COUNT;
+        m_measuring                   = false;
+    }
+
+    void DepthPrePass::collectResults()
+    {
+        for (int i = 0; i < m_QUERY_COUNT; ++i)
+        {
+            if (m_query_pixels[i] == 0)
+                continue;
+
+            GLint available = 0;
+            glGetQueryObjectiv(m_queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                continue;
+
+            GLuint samples = 0;
+            glGetQueryObjectuiv(m_queries[i], GL_QUERY_RESULT, &samples);
+            m_overdraw        = static_cast<float>(samples) / static_cast<float>(m_query_pixels[i]);
+            m_query_pixels[i] = 0;
+
+            // hysteresis, avoid flipping every frame around a single threshold
+            if (!m_auto_active && m_overdraw > m_ENABLE_OVERDRAW)
+                m_auto_active = true;
+            else if (m_auto_active && m_overdraw < m_DISABLE_OVERDRAW)
+                m_auto_active = false;
+        }
+    }
+} // namespace RealmEngine
@@ -0,0 +1,100 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/gl.h>
+
+#include <array>
+#include <glm/glm.hpp>
+#include <memory_resource>
+#include <vector>
+
+#include "render/pass.h"
+#include "render/pass/gbuffer_pass.h"
+#include "render/state.h"
+#include "resource/resource.h"
+
+namespace RealmEngine
+{
+    class FramebufferManager;
+    class StateManager;
+
+    enum class DepthPrePassMode : uint8_t
+    {
+        Off,  // never
+        On,   // every frame
+        Auto, // only while measured overdraw is high
+    };
+
+    /**
+     * @brief position-only pass filling gbuffer depth, so the gbuffer pass shades each pixel once
+     *
+     * In Auto mode the depth complexity of whichever pass lays down depth is measured with
+     * GL_SAMPLES_PASSED and the pre-pass is toggled with hysteresis.
+     */
+    class DepthPrePass : public RenderPass
+    {
+    public:
+        static constexpr float m_ENABLE_OVERDRAW  = 1.6f; // samples per pixel to turn the pre-pass on
+        static constexpr float m_DISABLE_OVERDRAW = 1.2f; // and to turn it off again
+
+        DepthPrePass(FramebufferManager* fb_mgr, StateManager* state_mgr);
+        ~DepthPrePass() override;
+
+        bool prepare() override;
+        void draw() override;
+        void clean() override;
+
+        void setRenderObjects(const std::pmr::vector<RenderObject>* objects) { m_render_objects = objects; }
+        void setDrawOrder(const std::vector<uint32_t>* order) { m_draw_order = order; }
+        void setViewMatrix(const glm::mat4& view) { m_view_matrix = view; }
+        void setProjectionMatrix(const glm::mat4& proj) { m_projection_matrix = proj; }
+        void setJitter(const glm::vec2& jitter) { m_jitter = jitter; }
+
+        void             setMode(DepthPrePassMode mode) { m_mode = mode; }
+        DepthPrePassMode getMode() const { return m_mode; }
+        bool             isActive() const;
+        float            getOverdraw() const { return m_overdraw; }
+
+        // wrap the pass that writes depth with GL_LESS this frame
+        void beginMeasure();
+        void endMeasure();
+
+    private:
+        static constexpr int m_QUERY_COUNT = 2;
+
+        FramebufferManager* m_framebuffer_mgr;
+        StateManager*       m_state_mgr;
+
+        StateManager::PipelineStateId m_pipeline_state {StateManager::m_DEFAULT_PIPELINE_STATE};
+
+        struct UniformLocations
+        {
+            GLint model {-1};
+            GLint position_scale {-1};
+            GLint position_offset {-1};
+        };
+
+        // one program per VertexFormat, m_shader is the Float32 one
+        std::array<std::shared_ptr<Shader>, g_vertex_format_count> m_format_shaders;
+        std::array<UniformLocations, g_vertex_format_count>        m_locations;
+
+        const std::pmr::vector<RenderObject>* m_render_objects {nullptr};
+        const std::vector<uint32_t>*          m_draw_order {nullptr};
+
+        glm::mat4 m_view_matrix {1.0f};
+        glm::mat4 m_projection_matrix {1.0f};
+        glm::vec2 m_jitter {0.0f};
+
+        DepthPrePassMode m_mode {DepthPrePassMode::Auto};
+        bool             m_auto_active {false};
+        float            m_overdraw {0.0f};
+
+        std::array<GLuint, m_QUERY_COUNT> m_queries {};
+        std::array<int, m_QUERY_COUNT>    m_query_pixels {}; // 0 = slot idle
+        int                               m_query_index {0};
+        bool                              m_measuring {false};
+
+        void collectResults();
+    };
+} // namespace RealmEngine
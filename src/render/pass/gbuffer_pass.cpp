@@ -5,13 +5,35 @@
 #include "render/state.h"
 #include "resource/model.h"
 #include "resource/shader.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cstring>
 
 namespace RealmEngine
 {
     GBufferPass::GBufferPass(FramebufferManager* fb_mgr, StateManager* state_mgr) :
         m_framebuffer_mgr(fb_mgr), m_state_mgr(state_mgr)
     {
-        m_shader = std::make_shared<Shader>("../shader/gbuffer.vert", "../shader/gbuffer.frag");
+        loadShader();
+
+        StateManager::State gbuffer_state;
+        gbuffer_state.enable_depth_test = true;
+        gbuffer_state.depth_func        = GL_LESS;
+        gbuffer_state.enable_culling    = true;
+        gbuffer_state.cull_face         = GL_BACK;
+        gbuffer_state.blending          = false;
+
+        // depth already laid down by the pre-pass
+        StateManager::State prepass_state = gbuffer_state;
+        prepass_state.depth_func          = GL_EQUAL;
+        prepass_state.depth_write         = false;
+
+        if (m_state_mgr)
+        {
+            m_pipeline_state         = m_state_mgr->createPipelineState(gbuffer_state);
+            m_prepass_pipeline_state = m_state_mgr->createPipelineState(prepass_state);
+        }
     }
 
     bool GBufferPass::prepare()
@@ -22,21 +44,28 @@ namespace RealmEngine
             return false;
         }
 
+        // gbuffer formats changed, switch to the matching shader variant
+        if (m_layout != m_framebuffer_mgr->getGBufferLayout())
+            loadShader();
+
         m_framebuffer_mgr->bindFrameBuffer(FramebufferType::GBuffer);
-        m_framebuffer_mgr->clearFrameBuffer(FramebufferType::GBuffer);
+        if (!m_depth_prepass)
+            m_framebuffer_mgr->clearFrameBuffer(FramebufferType::GBuffer);
 
-        StateManager::State gbuffer_state;
-        gbuffer_state.enable_depth_test = true;
-        gbuffer_state.depth_func        = GL_LESS;
-        gbuffer_state.enable_culling    = true;
-        gbuffer_state.cull_face         = GL_BACK;
-        gbuffer_state.blending          = false;
+        m_state_mgr->bindPipelineState(m_depth_prepass ? m_prepass_pipeline_state : m_pipeline_state);
 
-        m_state_mgr->pushState(gbuffer_state);
+        for (const auto& shader : m_format_shaders)
+        {
+            shader->use();
+            shader->setMat4("view", m_view_matrix);
+            shader->setMat4("projection", m_projection_matrix);
+            shader->setVec2("jitter", m_jitter);
 
-        m_shader->use();
-        m_shader->setMat4("view", m_view_matrix);
-        m_shader->setMat4("projection", m_projection_matrix);
+            // constant for every object until materials carry their own values
+            shader->setFloat("metallic", 0.0f);
+            shader->setFloat("roughness", 0.5f);
+            shader->setInt("shadingModel", 0);
+        }
 
         return true;
     }
@@ -46,38 +75,246 @@ namespace RealmEngine
         if (!prepare())
             return;
 
-        for (const auto& obj : m_render_objects)
+        if (!m_sorted)
+            sortRenderObjects();
+
+        recordCommands();
+
+        for (const auto& cmd : m_command_lists)
         {
-            renderObject(obj);
+            cmd.submit(*m_state_mgr);
         }
 
         clean();
     }
 
+    void GBufferPass::loadShader()
+    {
+        m_layout = m_framebuffer_mgr ? m_framebuffer_mgr->getGBufferLayout() : GBufferLayout::Standard;
+
+        for (size_t format = 0; format < g_vertex_format_count; ++format)
+        {
+            std::vector<std::string> defines;
+            if (m_layout == GBufferLayout::Compact)
+                defines.emplace_back("GBUFFER_COMPACT");
+            if (static_cast<VertexFormat>(format) == VertexFormat::Compressed)
+                defines.emplace_back("VERTEX_COMPRESSED");
+
+            auto shader = std::make_shared<Shader>("shader/gbuffer.vert", "shader/gbuffer.frag", defines);
+
+            UniformLocations& locations = m_locations[format];
+            locations.model             = shader->getUniformLocation("model");
+            locations.prev_mvp          = shader->getUniformLocation("prevMVP");
+            locations.texture_diffuse   = shader->getUniformLocation("texture_diffuse1");
+            locations.texture_normal    = shader->getUniformLocation("texture_normal1");
+            locations.texture_specular  = shader->getUniformLocation("texture_specular1");
+            locations.position_scale    = shader->getUniformLocation("positionScale");
+            locations.position_offset   = shader->getUniformLocation("positionOffset");
+
+            m_format_shaders[format] = std::move(shader);
+        }
+
+        m_shader = m_format_shaders[static_cast<size_t>(VertexFormat::Float32)];
+    }
+
     void GBufferPass::clean()
     {
-        m_state_mgr->popState();
         m_state_mgr->unbindVAO();
     }
 
-    void GBufferPass::addRenderObject(const RenderObject& obj) { m_render_objects.push_back(obj); }
+    void GBufferPass::addRenderObject(const RenderObject& obj)
+    {
+        m_render_objects.push_back(obj);
+        m_sorted = false;
+    }
 
-    void GBufferPass::clearRenderObjects() { m_render_objects.clear(); }
+    void GBufferPass::clearRenderObjects()
+    {
+        rebindContainer(m_render_objects, g_context.m_frame_allocator->getResource());
+        m_sorted = false;
+    }
 
-    void GBufferPass::renderObject(const RenderObject& obj)
+    void GBufferPass::sortRenderObjects()
     {
-        if (!obj.model)
-            return;
+        const size_t count = m_render_objects.size();
+        m_sort_keys.resize(count);
+        m_draw_order.resize(count);
 
-        m_shader->setMat4("model", obj.model_matrix);
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_sort_keys[i]  = makeSortKey(m_render_objects[i]);
+            m_draw_order[i] = static_cast<uint32_t>(i);
+        }
 
-        glm::mat4 prev_mvp = m_prev_vp_matrix * obj.prev_model_matrix;
-        m_shader->setMat4("prevMVP", prev_mvp);
+        radixSort(m_sort_keys, m_draw_order, m_sort_key_scratch, m_draw_order_scratch);
+        m_sorted = true;
+    }
 
-        m_shader->setFloat("metallic", 0.0f);
-        m_shader->setFloat("roughness", 0.5f);
-        m_shader->setInt("shadingModel", 0);
+    /**
+     * @brief pack draw state and distance into a key, ascending order = draw order
+     *
+     * | pass 4 | shader 8 | material 20 | view depth 32 |
+     *
+     * Depth is the raw bit pattern of a positive float, which orders the same as the value,
+     * so draws sharing state go front-to-back for early-z.
+     */
+    uint64_t GBufferPass::makeSortKey(const RenderObject& obj) const
+    {
+        constexpr uint64_t pass_id = 0; // opaque gbuffer
+
+        // program variant follows the vertex format
+        uint64_t shader_id   = obj.model ? static_cast<uint64_t>(obj.model->getVertexFormat()) : 0;
+        uint64_t material_id = obj.model ? (obj.model->getMaterialId() & 0xFFFFFu) : 0;
+
+        // view space looks down -z, origin of the object is a good enough proxy
+        float    view_depth = std::max(-(m_view_matrix * obj.model_matrix[3]).z, 0.0f);
+        uint32_t depth_bits = 0;
+        std::memcpy(&depth_bits, &view_depth, sizeof(depth_bits));
+
+        return (pass_id << 60) | (shader_id << 52) | (material_id << 32) | depth_bits;
+    }
+
+    /**
+     * @brief record the sorted draw order into command lists, one contiguous range per list
+     *
+     * Ranges are recorded as jobs (no GL calls), the first one on the calling thread.
+     * Submission order equals draw order, so the result is identical to a serial recording.
+     */
+    void GBufferPass::recordCommands()
+    {
+        const size_t count = m_draw_order.size();
+
+        size_t thread_count = static_cast<size_t>(g_context.m_jobs->getWorkerCount()) + 1;
+        size_t list_count   = std::clamp(count / m_MIN_DRAWS_PER_LIST, size_t {1}, m_MAX_COMMAND_LISTS);
+        list_count          = std::min(list_count, thread_count);
+
+        m_command_lists.resize(list_count);
+        for (auto& cmd : m_command_lists)
+        {
+            cmd.reset();
+        }
+        m_list_cluster_stats.assign(list_count, ClusterCullStats {});
+
+        // taa jitter is a clip-space translation applied in gbuffer.vert
+        glm::mat4 jitter_matrix(1.0f);
+        jitter_matrix[3][0]    = m_jitter.x;
+        jitter_matrix[3][1]    = m_jitter.y;
+        m_cull_view_projection = jitter_matrix * m_projection_matrix * m_view_matrix;
+
+        m_draws_per_list = (count + list_count - 1) / list_count;
+
+        // capture stays small enough for std::function's inline storage, no heap allocation per job
+        JobCounter recorded;
+        for (size_t i = 1; i < list_count; ++i)
+        {
+            g_context.m_jobs->submit([this, i]() { recordList(i); }, &recorded);
+        }
+
+        recordList(0);
+        g_context.m_jobs->wait(recorded);
+
+        m_cluster_stats = {};
+        for (const ClusterCullStats& stats : m_list_cluster_stats)
+        {
+            m_cluster_stats.tested += stats.tested;
+            m_cluster_stats.culled += stats.culled;
+        }
+    }
+
+    void GBufferPass::recordList(size_t list_index)
+    {
+        const size_t count = m_draw_order.size();
+        const size_t begin = std::min(list_index * m_draws_per_list, count);
+        const size_t end   = std::min(begin + m_draws_per_list, count);
+
+        // every list starts with its own program bind, lists may be replayed after one ending on another format
+        CommandBuffer& cmd            = m_command_lists[list_index];
+        size_t         current_format = g_vertex_format_count;
+        for (size_t i = begin; i < end; ++i)
+        {
+            const RenderObject& obj = m_render_objects[m_draw_order[i]];
+            if (!obj.model)
+                continue;
+
+            auto format = static_cast<size_t>(obj.model->getVertexFormat());
+            if (format != current_format)
+            {
+                cmd.useProgram(m_format_shaders[format]->getShaderProgram());
+                current_format = format;
+            }
+
+            recordObject(cmd, obj, m_locations[format], m_list_cluster_stats[list_index]);
+        }
+    }
+
+    /**
+     * @brief record one object's uniforms, textures and draws
+     *
+     * Texture i of a mesh goes to unit i, the first texture of each type feeds its sampler.
+     */
+    void GBufferPass::recordObject(CommandBuffer&          cmd,
+                                   const RenderObject&     obj,
+                                   const UniformLocations& locations,
+                                   ClusterCullStats&       stats) const
+    {
+        cmd.setUniformMat4(locations.model, obj.model_matrix);
+        cmd.setUniformMat4(locations.prev_mvp, m_prev_vp_matrix * obj.prev_model_matrix);
+
+        // built lazily, most objects have no meshlet meshes
+        ClusterCullView cull_view {};
+        bool            has_cull_view = false;
+
+        for (const auto& mesh : obj.model->getMeshes())
+        {
+            bool has_diffuse  = false;
+            bool has_normal   = false;
+            bool has_specular = false;
+
+            const auto& textures = mesh.getTextures();
+            for (uint32_t unit = 0; unit < textures.size(); ++unit)
+            {
+                const Texture& texture = textures[unit];
+                if (texture.type == Texture::Type::Diffuse && !has_diffuse)
+                {
+                    cmd.setUniformInt(locations.texture_diffuse, static_cast<int>(unit));
+                    has_diffuse = true;
+                }
+                else if (texture.type == Texture::Type::Normal && !has_normal)
+                {
+                    cmd.setUniformInt(locations.texture_normal, static_cast<int>(unit));
+                    has_normal = true;
+                }
+                else if (texture.type == Texture::Type::Specular && !has_specular)
+                {
+                    cmd.setUniformInt(locations.texture_specular, static_cast<int>(unit));
+                    has_specular = true;
+                }
 
-        obj.model->draw(m_shader->getShaderProgram());
+                cmd.bindTexture(unit, texture.id);
+            }
+
+            if (mesh.getVertexFormat() == VertexFormat::Compressed)
+            {
+                cmd.setUniformVec3(locations.position_scale, mesh.getPositionScale());
+                cmd.setUniformVec3(locations.position_offset, mesh.getPositionOffset());
+            }
+
+            cmd.bindVAO(mesh.getVAO());
+
+            // meshlets only cover lod 0
+            if ((obj.lod == 0 || mesh.getLodCount() == 1) && !mesh.getMeshlets().empty())
+            {
+                if (!has_cull_view)
+                {
+                    cull_view     = makeClusterCullView(m_cull_view_projection, obj.model_matrix, m_camera_position);
+                    has_cull_view = true;
+                }
+                recordVisibleMeshlets(cmd, mesh, cull_view, stats);
+                continue;
+            }
+
+            cmd.drawElements(
+                GL_TRIANGLES, mesh.getIndexCount(obj.lod), mesh.getIndexType(), mesh.getIndexByteOffset(obj.lod));
+        }
     }
-} // namespace RealmEngine
\ No newline at end of file
+} // namespace RealmEngine
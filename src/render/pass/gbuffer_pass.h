@@ -1,8 +1,16 @@
 #pragma once
 
+#include "render/command_buffer.h"
+#include "render/cluster_culling.h"
+#include "render/framebuffer.h"
 #include "render/pass.h"
+#include "render/state.h"
+#include "resource/resource.h"
 
+#include <array>
+#include <cstdint>
 #include <glm/glm.hpp>
+#include <memory_resource>
 #include <vector>
 
 namespace RealmEngine
@@ -16,6 +24,7 @@ namespace RealmEngine
         Model*    model;
         glm::mat4 model_matrix;
         glm::mat4 prev_model_matrix;
+        uint32_t  lod {0}; // picked from projected size when the draw list is built
     };
 
     class GBufferPass : public RenderPass
@@ -33,17 +42,78 @@ namespace RealmEngine
         void setViewMatrix(const glm::mat4& view) { m_view_matrix = view; }
         void setProjectionMatrix(const glm::mat4& proj) { m_projection_matrix = proj; }
         void setPrevViewProjectionMatrix(const glm::mat4& prev_vp) { m_prev_vp_matrix = prev_vp; }
+        void setJitter(const glm::vec2& jitter) { m_jitter = jitter; }
+        void setCameraPosition(const glm::vec3& position) { m_camera_position = position; }
+
+        // depth already laid down by DepthPrePass: no clear, GL_EQUAL, no depth writes
+        void setDepthPrePass(bool enabled) { m_depth_prepass = enabled; }
+
+        const std::pmr::vector<RenderObject>& getRenderObjects() const { return m_render_objects; }
+
+        // front-to-back, state-batched draw order as indices into getRenderObjects()
+        void                         sortRenderObjects();
+        const std::vector<uint32_t>& getDrawOrder() const { return m_draw_order; }
+
+        // meshlets of lod 0 draws tested / culled last frame
+        const ClusterCullStats& getClusterCullStats() const { return m_cluster_stats; }
 
     private:
         FramebufferManager* m_framebuffer_mgr;
         StateManager*       m_state_mgr;
+        GBufferLayout       m_layout {GBufferLayout::Standard};
+
+        StateManager::PipelineStateId m_pipeline_state {StateManager::m_DEFAULT_PIPELINE_STATE};
+        StateManager::PipelineStateId m_prepass_pipeline_state {StateManager::m_DEFAULT_PIPELINE_STATE};
+
+        std::pmr::vector<RenderObject> m_render_objects; // frame arena memory, rebound on clear
+
+        // per-frame sort state, kept as members so steady state does not allocate
+        std::vector<uint64_t> m_sort_keys;
+        std::vector<uint32_t> m_draw_order;
+        std::vector<uint64_t> m_sort_key_scratch;
+        std::vector<uint32_t> m_draw_order_scratch;
+        bool                  m_sorted {false};
+
+        // draw order is split into ranges recorded in parallel, then replayed in order
+        static constexpr size_t m_MIN_DRAWS_PER_LIST = 64;
+        static constexpr size_t m_MAX_COMMAND_LISTS  = 8;
+
+        std::vector<CommandBuffer>    m_command_lists;
+        std::vector<ClusterCullStats> m_list_cluster_stats; // one per list, summed after recording
+        ClusterCullStats              m_cluster_stats;
+        size_t                        m_draws_per_list {0};
+        glm::mat4                     m_cull_view_projection {1.0f}; // jittered, what the rasterizer sees
+
+        // resolved on the GL thread whenever the shader is (re)loaded, recording only reads them
+        struct UniformLocations
+        {
+            GLint model {-1};
+            GLint prev_mvp {-1};
+            GLint texture_diffuse {-1};
+            GLint texture_normal {-1};
+            GLint texture_specular {-1};
+            GLint position_scale {-1};
+            GLint position_offset {-1};
+        };
 
-        std::vector<RenderObject> m_render_objects;
+        // one program per VertexFormat, m_shader is the Float32 one
+        std::array<std::shared_ptr<Shader>, g_vertex_format_count> m_format_shaders;
+        std::array<UniformLocations, g_vertex_format_count>        m_locations;
 
         glm::mat4 m_view_matrix {1.0f};
         glm::mat4 m_projection_matrix {1.0f};
         glm::mat4 m_prev_vp_matrix {1.0f};
+        glm::vec2 m_jitter {0.0f};
+        glm::vec3 m_camera_position {0.0f};
+        bool      m_depth_prepass {false};
 
-        void renderObject(const RenderObject& obj);
+        uint64_t makeSortKey(const RenderObject& obj) const;
+        void     recordCommands();
+        void     recordList(size_t list_index);
+        void     recordObject(CommandBuffer&          cmd,
+                              const RenderObject&     obj,
+                              const UniformLocations& locations,
+                              ClusterCullStats&       stats) const;
+        void     loadShader();
     };
 } // namespace RealmEngine
\ No newline at end of file
@@ -5,13 +5,24 @@
 #include "resource/shader.h"
 #include "render/state.h"
 
+#include <algorithm>
+#include <string>
+
 namespace RealmEngine
 {
     LightingPass::LightingPass(FramebufferManager* fb_mgr, StateManager* state_mgr) :
         m_framebuffer_mgr(fb_mgr), m_state_mgr(state_mgr)
     {
-        m_shader = std::make_shared<Shader>("../shader/lighting.vert", "../shader/lighting.frag");
+        loadShader();
         createFullscreenQuad();
+
+        StateManager::State lighting_state;
+        lighting_state.enable_depth_test = false;
+        lighting_state.enable_culling    = false;
+        lighting_state.blending          = false;
+
+        if (m_state_mgr)
+            m_pipeline_state = m_state_mgr->createPipelineState(lighting_state);
     }
 
     bool LightingPass::prepare()
@@ -22,15 +33,14 @@ namespace RealmEngine
             return false;
         }
 
+        // gbuffer formats changed, switch to the matching shader variant
+        if (m_layout != m_framebuffer_mgr->getGBufferLayout())
+            loadShader();
+
         m_framebuffer_mgr->bindFrameBuffer(FramebufferType::PostProcess_A);
         m_framebuffer_mgr->clearFrameBuffer(FramebufferType::PostProcess_A);
 
-        StateManager::State lighting_state;
-        lighting_state.enable_depth_test = false;
-        lighting_state.enable_culling    = false;
-        lighting_state.blending          = false;
-
-        m_state_mgr->pushState(lighting_state);
+        m_state_mgr->bindPipelineState(m_pipeline_state);
 
         m_shader->use();
 
@@ -44,6 +54,7 @@ namespace RealmEngine
         m_shader->setInt("gMotionShadingModel", 2);
         m_shader->setInt("gDepth", 3);
 
+        m_shader->setVec2("gBufferUVScale", m_framebuffer_mgr->getUVScale(FramebufferType::GBuffer));
         m_shader->setMat4("invViewProjection", m_inv_view_projection);
         m_shader->setVec3("viewPos", m_view_pos);
 
@@ -61,9 +72,20 @@ namespace RealmEngine
         clean();
     }
 
+    void LightingPass::loadShader()
+    {
+        m_layout = m_framebuffer_mgr ? m_framebuffer_mgr->getGBufferLayout() : GBufferLayout::Standard;
+
+        std::vector<std::string> defines;
+        if (m_layout == GBufferLayout::Compact)
+            defines.emplace_back("GBUFFER_COMPACT");
+
+        m_shader = std::make_shared<Shader>("shader/lighting.vert", "shader/lighting.frag", defines);
+        resolveLightLocations();
+    }
+
     void LightingPass::clean()
     {
-        m_state_mgr->popState();
         m_state_mgr->unbindVAO();
         m_state_mgr->unbindAllTexture();
     }
@@ -74,8 +96,8 @@ namespace RealmEngine
 
     void LightingPass::clearLights()
     {
-        m_dir_lights.clear();
-        m_point_lights.clear();
+        rebindContainer(m_dir_lights, g_context.m_frame_allocator->getResource());
+        rebindContainer(m_point_lights, g_context.m_frame_allocator->getResource());
     }
 
     void LightingPass::createFullscreenQuad()
@@ -101,31 +123,59 @@ namespace RealmEngine
         glBindVertexArray(0);
     }
 
+    void LightingPass::resolveLightLocations()
+    {
+        for (int i = 0; i < m_MAX_DIR_LIGHTS; ++i)
+        {
+            std::string base = "dirLights[" + std::to_string(i) + "]";
+
+            auto& locations     = m_dir_light_locations[i];
+            locations.direction = m_shader->getUniformLocation(base + ".direction");
+            locations.color     = m_shader->getUniformLocation(base + ".color");
+            locations.intensity = m_shader->getUniformLocation(base + ".intensity");
+        }
+
+        for (int i = 0; i < m_MAX_POINT_LIGHTS; ++i)
+        {
+            std::string base = "pointLights[" + std::to_string(i) + "]";
+
+            auto& locations     = m_point_light_locations[i];
+            locations.position  = m_shader->getUniformLocation(base + ".position");
+            locations.color     = m_shader->getUniformLocation(base + ".color");
+            locations.intensity = m_shader->getUniformLocation(base + ".intensity");
+            locations.constant  = m_shader->getUniformLocation(base + ".constant");
+            locations.linear    = m_shader->getUniformLocation(base + ".linear");
+            locations.quadratic = m_shader->getUniformLocation(base + ".quadratic");
+        }
+    }
+
     void LightingPass::setupLightUniforms()
     {
-        int num_dir_lights   = static_cast<int>(m_dir_lights.size());
-        int num_point_lights = static_cast<int>(m_point_lights.size());
+        int num_dir_lights   = std::min(static_cast<int>(m_dir_lights.size()), m_MAX_DIR_LIGHTS);
+        int num_point_lights = std::min(static_cast<int>(m_point_lights.size()), m_MAX_POINT_LIGHTS);
 
         m_shader->setInt("numDirLights", num_dir_lights);
         m_shader->setInt("numPointLights", num_point_lights);
 
-        for (int i = 0; i < num_dir_lights && i < 4; ++i)
+        for (int i = 0; i < num_dir_lights; ++i)
         {
-            std::string base = "dirLights[" + std::to_string(i) + "]";
-            m_shader->setVec3(base + ".direction", m_dir_lights[i].direction);
-            m_shader->setVec3(base + ".color", m_dir_lights[i].color);
-            m_shader->setFloat(base + ".intensity", m_dir_lights[i].intensity);
+            const auto& light     = m_dir_lights[i];
+            const auto& locations = m_dir_light_locations[i];
+            glUniform3fv(locations.direction, 1, &light.direction[0]);
+            glUniform3fv(locations.color, 1, &light.color[0]);
+            glUniform1f(locations.intensity, light.intensity);
         }
 
-        for (int i = 0; i < num_point_lights && i < 32; ++i)
+        for (int i = 0; i < num_point_lights; ++i)
         {
-            std::string base = "pointLights[" + std::to_string(i) + "]";
-            m_shader->setVec3(base + ".position", m_point_lights[i].position);
-            m_shader->setVec3(base + ".color", m_point_lights[i].color);
-            m_shader->setFloat(base + ".intensity", m_point_lights[i].intensity);
-            m_shader->setFloat(base + ".constant", m_point_lights[i].constant);
-            m_shader->setFloat(base + ".linear", m_point_lights[i].linear);
-            m_shader->setFloat(base + ".quadratic", m_point_lights[i].quadratic);
+            const auto& light     = m_point_lights[i];
+            const auto& locations = m_point_light_locations[i];
+            glUniform3fv(locations.position, 1, &light.position[0]);
+            glUniform3fv(locations.color, 1, &light.color[0]);
+            glUniform1f(locations.intensity, light.intensity);
+            glUniform1f(locations.constant, light.constant);
+            glUniform1f(locations.linear, light.linear);
+            glUniform1f(locations.quadratic, light.quadratic);
         }
     }
 
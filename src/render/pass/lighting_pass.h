@@ -4,10 +4,14 @@
 #include <GLFW/glfw3.h>
 #include <glad/gl.h>
 
+#include <array>
 #include <glm/glm.hpp>
+#include <memory_resource>
 #include <vector>
 
+#include "render/framebuffer.h"
 #include "render/pass.h"
+#include "render/state.h"
 
 namespace RealmEngine
 {
@@ -50,9 +54,37 @@ namespace RealmEngine
     private:
         FramebufferManager* m_framebuffer_mgr;
         StateManager*       m_state_mgr;
+        GBufferLayout       m_layout {GBufferLayout::Standard};
 
-        std::vector<DirectionalLight> m_dir_lights;
-        std::vector<PointLight>       m_point_lights;
+        StateManager::PipelineStateId m_pipeline_state {StateManager::m_DEFAULT_PIPELINE_STATE};
+
+        static constexpr int m_MAX_DIR_LIGHTS   = 4;  // must match lighting.frag
+        static constexpr int m_MAX_POINT_LIGHTS = 32; // must match lighting.frag
+
+        // frame arena memory, rebound on clear
+        std::pmr::vector<DirectionalLight> m_dir_lights;
+        std::pmr::vector<PointLight>       m_point_lights;
+
+        // resolved once per shader load so per-frame uploads build no uniform names
+        struct DirLightLocations
+        {
+            GLint direction {-1};
+            GLint color {-1};
+            GLint intensity {-1};
+        };
+
+        struct PointLightLocations
+        {
+            GLint position {-1};
+            GLint color {-1};
+            GLint intensity {-1};
+            GLint constant {-1};
+            GLint linear {-1};
+            GLint quadratic {-1};
+        };
+
+        std::array<DirLightLocations, m_MAX_DIR_LIGHTS>     m_dir_light_locations;
+        std::array<PointLightLocations, m_MAX_POINT_LIGHTS> m_point_light_locations;
 
         glm::vec3 m_view_pos {0.0f};
         glm::mat4 m_inv_view_projection {1.0f};
@@ -62,6 +94,8 @@ namespace RealmEngine
 
         void createFullscreenQuad();
         void setupLightUniforms();
+        void resolveLightLocations();
         void renderFullscreenQuad();
+        void loadShader();
     };
 } // namespace RealmEngine
\ No newline at end of file
@@ -12,7 +12,7 @@ namespace RealmEngine
     public:
         bool prepare() override
         {
-            m_shader = std::make_unique<Shader>("../shader/shadow.vert", "../shader/shadow.frag");
+            m_shader = std::make_unique<Shader>("shader/shadow.vert", "shader/shadow.frag");
             return m_shader == nullptr;
         }
 
@@ -0,0 +1,96 @@
+#include "taa_pass.h"
+#include "global.h"
+#include "logger.h"
+#include "render/framebuffer.h"
+#include "render/state.h"
+#include "resource/shader.h"
+
+namespace RealmEngine
+{
+    TAAPass::TAAPass(FramebufferManager* fb_mgr, StateManager* state_mgr) :
+        m_framebuffer_mgr(fb_mgr), m_state_mgr(state_mgr)
+    {
+        m_shader = std::make_shared<Shader>("shader/taa.vert", "shader/taa.frag");
+
+        // fullscreen triangle is generated from gl_VertexID, core profile still needs a vao bound
+        glGenVertexArrays(1, &m_empty_vao);
+
+        StateManager::State taa_state;
+        taa_state.enable_depth_test = false;
+        taa_state.enable_culling    = false;
+        taa_state.blending          = false;
+
+        if (m_state_mgr)
+            m_pipeline_state = m_state_mgr->createPipelineState(taa_state);
+    }
+
+    TAAPass::~TAAPass()
+    {
+        if (m_empty_vao != 0)
+            glDeleteVertexArrays(1, &m_empty_vao);
+    }
+
+    bool TAAPass::prepare()
+    {
+        if (!m_shader || !m_framebuffer_mgr || !m_state_mgr)
+        {
+            LOG_ERROR("TAAPass not properly initialized");
+            return false;
+        }
+
+        // history textures were reallocated, their content is garbage
+        if (m_fb_generation != m_framebuffer_mgr->getGeneration())
+        {
+            m_fb_generation = m_framebuffer_mgr->getGeneration();
+            m_history_valid = false;
+        }
+
+        m_output = m_write_a ? FramebufferType::TemporalHistory_A : FramebufferType::TemporalHistory_B;
+        const AttachmentType history = m_write_a ? AttachmentType::History_B : AttachmentType::History_A;
+
+        m_framebuffer_mgr->bindFrameBuffer(m_output);
+
+        m_state_mgr->bindPipelineState(m_pipeline_state);
+
+        m_shader->use();
+
+        m_framebuffer_mgr->bindAttachment(AttachmentType::HDR_Color, 0);
+        m_framebuffer_mgr->bindAttachment(history, 1);
+        m_framebuffer_mgr->bindAttachment(AttachmentType::GBuffer_Motion, 2);
+
+        m_shader->setInt("currentColor", 0);
+        m_shader->setInt("historyColor", 1);
+        m_shader->setInt("gMotion", 2);
+
+        m_shader->setVec2("currentUVScale", m_framebuffer_mgr->getUVScale(FramebufferType::PostProcess_A));
+        m_shader->setVec2("historyUVScale", m_framebuffer_mgr->getUVScale(m_output));
+        m_shader->setVec2("currentTexelSize",
+                          glm::vec2(1.0f / static_cast<float>(m_framebuffer_mgr->getRenderWidth()),
+                                    1.0f / static_cast<float>(m_framebuffer_mgr->getRenderHeight())));
+        m_shader->setVec2("jitter", m_jitter);
+        m_shader->setBool("historyValid", m_history_valid);
+
+        return true;
+    }
+
+    void TAAPass::draw()
+    {
+        if (!prepare())
+            return;
+
+        m_state_mgr->bindVAO(m_empty_vao);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        clean();
+    }
+
+    void TAAPass::clean()
+    {
+        m_state_mgr->unbindVAO();
+        m_state_mgr->unbindAllTexture();
+
+        // this frame's output becomes next frame's history
+        m_history_valid = true;
+        m_write_a       = !m_write_a;
+    }
+} // namespace RealmEngine
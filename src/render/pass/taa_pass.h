@@ -0,0 +1,54 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/gl.h>
+
+#include <glm/glm.hpp>
+
+#include "render/framebuffer.h"
+#include "render/pass.h"
+#include "render/state.h"
+
+namespace RealmEngine
+{
+    class FramebufferManager;
+    class StateManager;
+
+    /**
+     * @brief temporal anti-aliasing / temporal upsampling
+     *
+     * Resolves the jittered lighting result (render resolution) against a reprojected
+     * history (output resolution), clamped to the current frame's 3x3 neighbourhood.
+     */
+    class TAAPass : public RenderPass
+    {
+    public:
+        TAAPass(FramebufferManager* fb_mgr, StateManager* state_mgr);
+        ~TAAPass() override;
+
+        bool prepare() override;
+        void draw() override;
+        void clean() override;
+
+        void setJitter(const glm::vec2& jitter) { m_jitter = jitter; }
+        void invalidateHistory() { m_history_valid = false; }
+
+        // framebuffer holding the last resolved output
+        FramebufferType getOutput() const { return m_output; }
+
+    private:
+        FramebufferManager* m_framebuffer_mgr;
+        StateManager*       m_state_mgr;
+
+        StateManager::PipelineStateId m_pipeline_state {StateManager::m_DEFAULT_PIPELINE_STATE};
+
+        GLuint    m_empty_vao {0};
+        glm::vec2 m_jitter {0.0f};
+        bool      m_history_valid {false};
+        bool      m_write_a {true};
+
+        FramebufferType m_output {FramebufferType::TemporalHistory_A};
+        uint32_t  m_fb_generation {0};
+    };
+} // namespace RealmEngine
@@ -2,9 +2,17 @@
 #include "global.h"
 #include "logger.h"
 #include "render/framebuffer.h"
+#include "render/pass/depth_prepass.h"
 #include "render/pass/gbuffer_pass.h"
 #include "render/pass/lighting_pass.h"
+#include "render/pass/taa_pass.h"
 #include "render/state.h"
+#include "render/texture_streamer.h"
+#include "resource/model.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 namespace RealmEngine
 {
@@ -37,6 +45,10 @@ namespace RealmEngine
     {
         m_gbuffer_pass  = std::make_unique<GBufferPass>(fb_mgr, state_mgr);
         m_lighting_pass = std::make_unique<LightingPass>(fb_mgr, state_mgr);
+        m_taa_pass      = std::make_unique<TAAPass>(fb_mgr, state_mgr);
+        m_depth_prepass = std::make_unique<DepthPrePass>(fb_mgr, state_mgr);
+        m_depth_prepass->setRenderObjects(&m_gbuffer_pass->getRenderObjects());
+        m_depth_prepass->setDrawOrder(&m_gbuffer_pass->getDrawOrder());
     }
 
     DeferredPipeline::~DeferredPipeline() = default;
@@ -56,6 +68,8 @@ namespace RealmEngine
     {
         m_gbuffer_pass.reset();
         m_lighting_pass.reset();
+        m_taa_pass.reset();
+        m_depth_prepass.reset();
         LOG_INFO("DeferredPipeline terminated");
     }
 
@@ -65,11 +79,31 @@ namespace RealmEngine
         m_projection_matrix = projection;
         m_camera_position   = position;
 
+        // sub-pixel jitter in render resolution pixels, halton(2,3) keeps samples well distributed
+        m_jitter = glm::vec2(0.0f);
+        if (m_taa_enabled && m_taa_pass)
+        {
+            uint32_t  phase = (m_frame_index++ % m_JITTER_PHASES) + 1;
+            glm::vec2 offset(halton(phase, 2) - 0.5f, halton(phase, 3) - 0.5f);
+            m_jitter = glm::vec2(offset.x * 2.0f / static_cast<float>(m_framebuffer_mgr->getRenderWidth()),
+                                 offset.y * 2.0f / static_cast<float>(m_framebuffer_mgr->getRenderHeight()));
+            m_taa_pass->setJitter(m_jitter);
+        }
+
         if (m_gbuffer_pass)
         {
             m_gbuffer_pass->setViewMatrix(view);
             m_gbuffer_pass->setProjectionMatrix(projection);
             m_gbuffer_pass->setPrevViewProjectionMatrix(m_prev_view_projection);
+            m_gbuffer_pass->setJitter(m_jitter);
+            m_gbuffer_pass->setCameraPosition(position);
+        }
+
+        if (m_depth_prepass)
+        {
+            m_depth_prepass->setViewMatrix(view);
+            m_depth_prepass->setProjectionMatrix(projection);
+            m_depth_prepass->setJitter(m_jitter);
         }
 
         if (m_lighting_pass)
@@ -82,18 +116,115 @@ namespace RealmEngine
         m_prev_view_projection = projection * view;
     }
 
-    void DeferredPipeline::addRenderObject(Model* model, const glm::mat4& model_matrix)
+    ClusterCullStats DeferredPipeline::getClusterCullStats() const
+    {
+        return m_gbuffer_pass ? m_gbuffer_pass->getClusterCullStats() : ClusterCullStats {};
+    }
+
+    void DeferredPipeline::setTemporalAA(bool enabled)
+    {
+        if (m_taa_enabled == enabled)
+            return;
+
+        m_taa_enabled = enabled;
+        if (m_taa_pass)
+            m_taa_pass->invalidateHistory();
+    }
+
+    void DeferredPipeline::setDepthPrePassMode(DepthPrePassMode mode)
+    {
+        if (m_depth_prepass)
+            m_depth_prepass->setMode(mode);
+    }
+
+    float DeferredPipeline::halton(uint32_t index, uint32_t base)
+    {
+        float result   = 0.0f;
+        float fraction = 1.0f / static_cast<float>(base);
+        while (index > 0)
+        {
+            result += static_cast<float>(index % base) * fraction;
+            index /= base;
+            fraction /= static_cast<float>(base);
+        }
+        return result;
+    }
+
+    void DeferredPipeline::addRenderObject(Model* model, const glm::mat4& model_matrix, RenderObjectHandle handle)
     {
-        if (m_gbuffer_pass && model)
+        // skipped until its staged geometry is on the gpu, a frame or two after loading
+        if (m_gbuffer_pass && model && model->isUploaded())
         {
             RenderObject obj;
-            obj.model             = model;
-            obj.model_matrix      = model_matrix;
-            obj.prev_model_matrix = model_matrix; // TODO: Track previous frame transform
+            obj.model        = model;
+            obj.model_matrix = model_matrix;
+            // objects without a handle have no history, they report camera motion only
+            obj.prev_model_matrix =
+                handle != g_invalid_render_object ? m_transform_history.update(handle, model_matrix) : model_matrix;
+
+            float pixels_per_unit = getPixelsPerUnit(*model, model_matrix);
+            obj.lod               = selectLod(*model, pixels_per_unit);
+            requestTextureDetail(*model, pixels_per_unit);
+
             m_gbuffer_pass->addRenderObject(obj);
         }
     }
 
+    /**
+     * @brief render resolution pixels one model unit covers at the nearest point of the bounding sphere
+     *
+     * Infinite when the camera is inside the sphere.
+     */
+    float DeferredPipeline::getPixelsPerUnit(const Model& model, const glm::mat4& model_matrix) const
+    {
+        float scale = std::max({glm::length(glm::vec3(model_matrix[0])),
+                                glm::length(glm::vec3(model_matrix[1])),
+                                glm::length(glm::vec3(model_matrix[2]))});
+
+        glm::vec3 local_center = (model.getBoundsMin() + model.getBoundsMax()) * 0.5f;
+        glm::vec3 center       = glm::vec3(model_matrix * glm::vec4(local_center, 1.0f));
+        float     radius       = glm::length(model.getBoundsMax() - model.getBoundsMin()) * 0.5f * scale;
+        float     distance     = glm::length(center - m_camera_position) - radius;
+        if (distance <= 0.0f)
+            return std::numeric_limits<float>::infinity();
+
+        // model units -> pixels at that distance, projection[1][1] = cot(fov_y / 2)
+        float render_height = static_cast<float>(m_framebuffer_mgr->getRenderHeight());
+        return scale * m_projection_matrix[1][1] * 0.5f * render_height / distance;
+    }
+
+    /**
+     * @brief project each level's error with pixels_per_unit, keep the coarsest under budget
+     */
+    uint32_t DeferredPipeline::selectLod(const Model& model, float pixels_per_unit) const
+    {
+        if (model.getLodCount() <= 1 || std::isinf(pixels_per_unit))
+            return 0;
+
+        uint32_t lod = 0;
+        for (size_t level = 1; level < model.getLodCount(); ++level)
+        {
+            if (model.getLodError(level) * pixels_per_unit > m_lod_pixel_error)
+                break;
+            lod = static_cast<uint32_t>(level);
+        }
+        return lod;
+    }
+
+    /**
+     * @brief ask for mips matching the model's on-screen extent, textures are assumed to span the model once
+     */
+    void DeferredPipeline::requestTextureDetail(const Model& model, float pixels_per_unit) const
+    {
+        if (!m_texture_streamer)
+            return;
+
+        float extent        = glm::length(model.getBoundsMax() - model.getBoundsMin());
+        float screen_pixels = extent * pixels_per_unit;
+        for (const Texture& texture : model.getTextures())
+            m_texture_streamer->requestSize(texture.id, screen_pixels);
+    }
+
     void DeferredPipeline::addDirectionalLight(const glm::vec3& direction, const glm::vec3& color, float intensity)
     {
         if (m_lighting_pass)
@@ -132,6 +263,8 @@ namespace RealmEngine
         {
             m_gbuffer_pass->clearRenderObjects();
         }
+
+        m_transform_history.nextFrame();
     }
 
     void DeferredPipeline::renderShadowMaps()
@@ -141,10 +274,29 @@ namespace RealmEngine
 
     void DeferredPipeline::renderGBuffer()
     {
-        if (m_gbuffer_pass)
+        if (!m_gbuffer_pass)
+            return;
+
+        const bool prepass = m_depth_prepass && m_depth_prepass->isActive();
+
+        // one sort shared by the pre-pass and the gbuffer pass
+        m_gbuffer_pass->sortRenderObjects();
+
+        // overdraw is measured on whichever pass lays down depth with GL_LESS
+        if (m_depth_prepass)
+            m_depth_prepass->beginMeasure();
+
+        if (prepass)
         {
-            m_gbuffer_pass->draw();
+            m_depth_prepass->draw();
+            m_depth_prepass->endMeasure();
         }
+
+        m_gbuffer_pass->setDepthPrePass(prepass);
+        m_gbuffer_pass->draw();
+
+        if (m_depth_prepass && !prepass)
+            m_depth_prepass->endMeasure();
     }
 
     void DeferredPipeline::renderLighting()
@@ -163,6 +315,17 @@ namespace RealmEngine
     void DeferredPipeline::renderPostProcess()
     {
         // TODO: Implement post processing
+
+        // resolve jittered frame against history, output is already at window resolution
+        if (m_taa_enabled && m_taa_pass)
+        {
+            m_taa_pass->draw();
+            m_framebuffer_mgr->blitToDefault(m_taa_pass->getOutput());
+            return;
+        }
+
+        // upscale internal resolution to the window
+        m_framebuffer_mgr->blitToDefault(FramebufferType::PostProcess_A);
     }
 
     void DeferredPipeline::renderUI()
@@ -1,8 +1,12 @@
 #pragma once
 
+#include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
 
+#include "render/cluster_culling.h"
+#include "render/transform_history.h"
+
 namespace RealmEngine
 {
     class Model;
@@ -10,6 +14,10 @@ namespace RealmEngine
     class StateManager;
     class GBufferPass;
     class LightingPass;
+    class TAAPass;
+    class DepthPrePass;
+    class TextureStreamer;
+    enum class DepthPrePassMode : uint8_t;
 
     class Pipeline
     {
@@ -62,12 +70,31 @@ namespace RealmEngine
         }
 
         void setCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& position);
-        void addRenderObject(Model* model, const glm::mat4& model_matrix);
+        RenderObjectHandle createRenderObject() { return m_transform_history.allocate(); }
+        void               destroyRenderObject(RenderObjectHandle handle) { m_transform_history.release(handle); }
+
+        void addRenderObject(Model*             model,
+                             const glm::mat4&   model_matrix,
+                             RenderObjectHandle handle = g_invalid_render_object);
         void addDirectionalLight(const glm::vec3& direction, const glm::vec3& color, float intensity);
         void addPointLight(const glm::vec3& position, const glm::vec3& color, float intensity);
         void clearLights();
         void clearRenderObjects();
 
+        void setTemporalAA(bool enabled);
+        bool isTemporalAAEnabled() const { return m_taa_enabled; }
+
+        void setDepthPrePassMode(DepthPrePassMode mode);
+
+        // coarsest lod whose simplification error stays below this many pixels at render resolution
+        void  setLodPixelError(float pixels) { m_lod_pixel_error = pixels; }
+        float getLodPixelError() const { return m_lod_pixel_error; }
+
+        ClusterCullStats getClusterCullStats() const;
+
+        // receives the on-screen size of every drawn model's textures
+        void setTextureStreamer(TextureStreamer* streamer) { m_texture_streamer = streamer; }
+
     protected:
         void renderShadowMaps();
         void renderGBuffer();
@@ -82,10 +109,29 @@ namespace RealmEngine
 
         std::unique_ptr<GBufferPass>  m_gbuffer_pass;
         std::unique_ptr<LightingPass> m_lighting_pass;
+        std::unique_ptr<TAAPass>      m_taa_pass;
+        std::unique_ptr<DepthPrePass> m_depth_prepass;
+
+        TransformHistory m_transform_history;
 
         glm::mat4 m_view_matrix {1.0f};
         glm::mat4 m_projection_matrix {1.0f};
         glm::mat4 m_prev_view_projection {1.0f};
         glm::vec3 m_camera_position {0.0f};
+
+        // taa jitter sequence
+        static constexpr int m_JITTER_PHASES = 8;
+
+        bool      m_taa_enabled {true};
+        uint32_t  m_frame_index {0};
+        glm::vec2 m_jitter {0.0f};
+
+        float            m_lod_pixel_error {1.0f};
+        TextureStreamer* m_texture_streamer {nullptr};
+
+        float        getPixelsPerUnit(const Model& model, const glm::mat4& model_matrix) const;
+        uint32_t     selectLod(const Model& model, float pixels_per_unit) const;
+        void         requestTextureDetail(const Model& model, float pixels_per_unit) const;
+        static float halton(uint32_t index, uint32_t base);
     };
 } // namespace RealmEngine
\ No newline at end of file
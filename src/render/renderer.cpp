@@ -20,13 +20,16 @@ namespace RealmEngine
         }
 
         // initialize imgui
-        IMGUI_CHECKVERSION();
-        ImGui::CreateContext();
-        ImGuiIO& io = ImGui::GetIO();
-        io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
-        io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;
-        ImGui_ImplGlfw_InitForOpenGL(g_context.m_window->getGLFWwindow(), GLFW_TRUE);
-        ImGui_ImplOpenGL3_Init();
+        {
+            MEMORY_SCOPE(MemoryTag::UI);
+            IMGUI_CHECKVERSION();
+            ImGui::CreateContext();
+            ImGuiIO& io = ImGui::GetIO();
+            io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;
+            io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;
+            ImGui_ImplGlfw_InitForOpenGL(g_context.m_window->getGLFWwindow(), GLFW_TRUE);
+            ImGui_ImplOpenGL3_Init();
+        }
 
         // initialize managers
         m_state_mgr       = std::make_unique<StateManager>();
@@ -36,6 +39,15 @@ namespace RealmEngine
         int height = g_context.m_window->getFramebufferHeight();
         m_framebuffer_mgr->initialize(width, height);
 
+        m_dynamic_resolution = std::make_unique<DynamicResolution>();
+        m_dynamic_resolution->initialize();
+
+        m_staging_ring = std::make_unique<StagingRing>();
+        m_staging_ring->initialize();
+
+        m_texture_streamer = std::make_unique<TextureStreamer>();
+        m_texture_streamer->initialize(m_state_mgr.get(), m_staging_ring.get());
+
         if (m_mode == RenderMode::Defferd)
         {
             m_pipeline = std::make_unique<DeferredPipeline>(m_framebuffer_mgr.get(), m_state_mgr.get());
@@ -47,6 +59,12 @@ namespace RealmEngine
 
         m_pipeline->initialize();
 
+        if (auto* deferred_pipeline = dynamic_cast<DeferredPipeline*>(m_pipeline.get()))
+            deferred_pipeline->setTextureStreamer(m_texture_streamer.get());
+
+        // follow window framebuffer size
+        g_context.m_window->registerOnFramebufferSizeFunc([this](int w, int h) { requestResize(w, h); });
+
         m_initialized = true;
         LOG_INFO("Renderer initialized");
     }
@@ -59,6 +77,11 @@ namespace RealmEngine
             return;
         }
 
+        m_dynamic_resolution->terminate();
+        // drops queued uploads first, they reference streamed textures
+        m_staging_ring->terminate();
+        m_texture_streamer->terminate();
+
         // clean imgui
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
@@ -68,13 +91,53 @@ namespace RealmEngine
         LOG_INFO("Renderer terminated");
     }
 
-    void Renderer::beginFrame() const
+    void Renderer::beginFrame()
     {
         if (!m_initialized)
         {
             LOG_ERROR("Renderer not initialized");
             return;
         }
+
+        applyPendingResize();
+
+        m_state_mgr->resetStats();
+
+        // issue uploads written since last frame, staged meshes and mips become usable
+        m_staging_ring->update();
+
+        // this frame's size requests are in, stream before anything samples
+        m_texture_streamer->update();
+
+        // pick internal resolution for this frame
+        m_framebuffer_mgr->setRenderScale(m_dynamic_resolution->getScale());
+    }
+
+    void Renderer::requestResize(int width, int height)
+    {
+        // ignore minimize, keep last valid size
+        if (width <= 0 || height <= 0)
+            return;
+
+        m_pending_width       = width;
+        m_pending_height      = height;
+        m_resize_request_time = glfwGetTime();
+        m_resize_pending      = true;
+    }
+
+    void Renderer::applyPendingResize()
+    {
+        if (!m_resize_pending || !m_framebuffer_mgr)
+            return;
+
+        // resizes inside the current allocation are free, apply them immediately.
+        // reallocations wait until the window stops changing size (interactive drags)
+        if (m_framebuffer_mgr->needsReallocation(m_pending_width, m_pending_height) &&
+            glfwGetTime() - m_resize_request_time < m_RESIZE_DEBOUNCE)
+            return;
+
+        m_framebuffer_mgr->resize(m_pending_width, m_pending_height);
+        m_resize_pending = false;
     }
 
     void Renderer::endFrame() const
@@ -86,14 +149,63 @@ namespace RealmEngine
         }
     }
 
-    void Renderer::addRenderObject(Model* model, const glm::mat4& model_matrix)
+    void Renderer::setFrameTimeBudget(float budget_ms)
+    {
+        if (m_dynamic_resolution)
+            m_dynamic_resolution->setFrameTimeBudget(budget_ms);
+    }
+
+    float Renderer::getFrameTimeBudget() const
+    {
+        return m_dynamic_resolution ? m_dynamic_resolution->getFrameTimeBudget() : 0.0f;
+    }
+
+    void Renderer::setDynamicResolution(bool enabled)
+    {
+        if (m_dynamic_resolution)
+            m_dynamic_resolution->setEnabled(enabled);
+    }
+
+    float Renderer::getRenderScale() const { return m_framebuffer_mgr ? m_framebuffer_mgr->getRenderScale() : 1.0f; }
+
+    float Renderer::getGPUFrameTime() const
+    {
+        return m_dynamic_resolution ? m_dynamic_resolution->getGPUTime() : 0.0f;
+    }
+
+    RenderObjectHandle Renderer::createRenderObject()
+    {
+        if (m_mode == RenderMode::Defferd)
+        {
+            auto* deferred_pipeline = dynamic_cast<DeferredPipeline*>(m_pipeline.get());
+            if (deferred_pipeline)
+            {
+                return deferred_pipeline->createRenderObject();
+            }
+        }
+        return g_invalid_render_object;
+    }
+
+    void Renderer::destroyRenderObject(RenderObjectHandle handle)
+    {
+        if (m_mode == RenderMode::Defferd)
+        {
+            auto* deferred_pipeline = dynamic_cast<DeferredPipeline*>(m_pipeline.get());
+            if (deferred_pipeline)
+            {
+                deferred_pipeline->destroyRenderObject(handle);
+            }
+        }
+    }
+
+    void Renderer::addRenderObject(Model* model, const glm::mat4& model_matrix, RenderObjectHandle handle)
     {
         if (m_mode == RenderMode::Defferd)
         {
             auto* deferred_pipeline = dynamic_cast<DeferredPipeline*>(m_pipeline.get());
             if (deferred_pipeline)
             {
-                deferred_pipeline->addRenderObject(model, model_matrix);
+                deferred_pipeline->addRenderObject(model, model_matrix, handle);
             }
         }
     }
@@ -134,20 +246,80 @@ namespace RealmEngine
         }
     }
 
+    void Renderer::setGBufferLayout(GBufferLayout layout)
+    {
+        if (m_framebuffer_mgr)
+            m_framebuffer_mgr->setGBufferLayout(layout);
+    }
+
+    void Renderer::setDepthPrePassMode(DepthPrePassMode mode)
+    {
+        if (m_mode == RenderMode::Defferd)
+        {
+            auto* deferred_pipeline = dynamic_cast<DeferredPipeline*>(m_pipeline.get());
+            if (deferred_pipeline)
+            {
+                deferred_pipeline->setDepthPrePassMode(mode);
+            }
+        }
+    }
+
+    ClusterCullStats Renderer::getClusterCullStats() const
+    {
+        auto* deferred_pipeline = dynamic_cast<DeferredPipeline*>(m_pipeline.get());
+        return deferred_pipeline ? deferred_pipeline->getClusterCullStats() : ClusterCullStats {};
+    }
+
+    void Renderer::setTextureBudget(size_t bytes)
+    {
+        if (m_texture_streamer)
+            m_texture_streamer->setBudget(bytes);
+    }
+
+    void Renderer::setLodPixelError(float pixels)
+    {
+        if (m_mode == RenderMode::Defferd)
+        {
+            auto* deferred_pipeline = dynamic_cast<DeferredPipeline*>(m_pipeline.get());
+            if (deferred_pipeline)
+            {
+                deferred_pipeline->setLodPixelError(pixels);
+            }
+        }
+    }
+
+    void Renderer::setTemporalAA(bool enabled)
+    {
+        if (m_mode == RenderMode::Defferd)
+        {
+            auto* deferred_pipeline = dynamic_cast<DeferredPipeline*>(m_pipeline.get());
+            if (deferred_pipeline)
+            {
+                deferred_pipeline->setTemporalAA(enabled);
+            }
+        }
+    }
+
     void Renderer::renderFrame()
     {
         if (!m_initialized || !m_pipeline)
             return;
 
+        MEMORY_SCOPE(MemoryTag::Render);
+
         beginFrame();
 
+        m_dynamic_resolution->beginFrame();
         m_pipeline->render();
+        m_dynamic_resolution->endFrame();
 
         if (m_mode == RenderMode::Defferd)
         {
             auto* deferred_pipeline = dynamic_cast<DeferredPipeline*>(m_pipeline.get());
             if (deferred_pipeline)
             {
+                // per-frame lists are rebound to the next arena when cleared
+                g_context.m_frame_allocator->nextFrame();
                 deferred_pipeline->clearRenderObjects();
                 deferred_pipeline->clearLights();
             }
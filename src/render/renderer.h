@@ -8,9 +8,13 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <memory>
 
+#include "render/dynamic_resolution.h"
 #include "render/framebuffer.h"
+#include "render/pass/depth_prepass.h"
 #include "render/pipeline.h"
+#include "render/staging_ring.h"
 #include "render/state.h"
+#include "render/texture_streamer.h"
 
 namespace RealmEngine
 {
@@ -32,21 +36,65 @@ namespace RealmEngine
 
         void setRenderMode(RenderMode mode) { m_mode = mode; };
 
-        void addRenderObject(Model* model, const glm::mat4& model_matrix);
+        RenderObjectHandle createRenderObject();
+        void               destroyRenderObject(RenderObjectHandle handle);
+
+        // pass a handle from createRenderObject() to get per-object motion vectors
+        void addRenderObject(Model*             model,
+                             const glm::mat4&   model_matrix,
+                             RenderObjectHandle handle = g_invalid_render_object);
         void addDirectionalLight(const glm::vec3& direction, const glm::vec3& color, float intensity = 1.0f);
         void addPointLight(const glm::vec3& position, const glm::vec3& color, float intensity = 1.0f);
         void setMainCamera(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& position);
+        void setTemporalAA(bool enabled);
+        void setGBufferLayout(GBufferLayout layout);
+        void setDepthPrePassMode(DepthPrePassMode mode);
+        void setLodPixelError(float pixels);
 
         void renderFrame();
 
+        void requestResize(int width, int height);
+
+        // hard gpu frame-time budget in ms, internal resolution drops to stay under it (<= 0 disables)
+        void  setFrameTimeBudget(float budget_ms);
+        float getFrameTimeBudget() const;
+        void  setDynamicResolution(bool enabled);
+        float getRenderScale() const;
+        float getGPUFrameTime() const;
+
+        const StateManager::Stats& getStateStats() const { return m_state_mgr->getStats(); }
+        ClusterCullStats           getClusterCullStats() const;
+
+        // every model texture is created through this, see TextureStreamer
+        TextureStreamer*              getTextureStreamer() const { return m_texture_streamer.get(); }
+        void                          setTextureBudget(size_t bytes);
+        const TextureStreamer::Stats& getTextureStats() const { return m_texture_streamer->getStats(); }
+
+        // texture and buffer uploads go through this instead of client memory, see StagingRing
+        StagingRing*              getStagingRing() const { return m_staging_ring.get(); }
+        const StagingRing::Stats& getStagingStats() const { return m_staging_ring->getStats(); }
+
+        // reallocating resizes are applied once the size has been stable for this long (seconds)
+        static constexpr double m_RESIZE_DEBOUNCE = 0.15;
+
     private:
         std::unique_ptr<Pipeline>           m_pipeline;
         std::unique_ptr<StateManager>       m_state_mgr;
         std::unique_ptr<FramebufferManager> m_framebuffer_mgr;
+        std::unique_ptr<DynamicResolution>  m_dynamic_resolution;
+        std::unique_ptr<TextureStreamer>    m_texture_streamer;
+        std::unique_ptr<StagingRing>        m_staging_ring;
         bool                                m_initialized = false;
         RenderMode                          m_mode {RenderMode::Defferd};
 
-        void beginFrame() const;
+        // pending resize from window callback
+        bool   m_resize_pending {false};
+        int    m_pending_width {0};
+        int    m_pending_height {0};
+        double m_resize_request_time {0.0};
+
+        void applyPendingResize();
+        void beginFrame();
         void endFrame() const;
     };
 } // namespace RealmEngine
\ No newline at end of file
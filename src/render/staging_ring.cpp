@@ -0,0 +1,260 @@
+#include "staging_ring.h"
+#include "logger.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace RealmEngine
+{
+    void StagingRing::initialize(size_t size)
+    {
+        m_size = size;
+        glGenBuffers(1, &m_buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(m_size), nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        m_stats.capacity = m_size;
+        m_terminating    = false;
+        openMapping();
+
+        LOG_INFO("StagingRing initialized, " + std::to_string(m_size >> 20) + " MB");
+    }
+
+    void StagingRing::terminate()
+    {
+        {
+            // no new allocations, and writers already copying into the mapping finish before it goes away;
+            // that is one memcpy each. Their submits then find a closed epoch and are dropped
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_terminating = true;
+            m_writers_done.wait(lock, [this]() { return m_writers == 0; });
+
+            if (m_mapped)
+            {
+                glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+                glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+                glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            }
+            m_mapped = nullptr;
+            ++m_epoch;
+            m_commands.clear();
+        }
+
+        for (const Region& region : m_regions)
+            glDeleteSync(region.fence);
+        m_regions.clear();
+
+        glDeleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+
+        LOG_INFO("StagingRing terminated");
+    }
+
+    StagingRing::Allocation StagingRing::allocate(size_t size, size_t alignment)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        size_t offset = (m_write + alignment - 1) / alignment * alignment;
+        if (!m_mapped || m_terminating || size == 0 || offset > m_map_end || size > m_map_end - offset)
+        {
+            ++m_failed_allocations;
+            return {};
+        }
+
+        Allocation allocation;
+        allocation.data   = m_mapped + (offset - m_map_begin);
+        allocation.offset = offset;
+        allocation.size   = size;
+        allocation.epoch  = m_epoch;
+
+        m_write = offset + size;
+        ++m_writers;
+        return allocation;
+    }
+
+    void StagingRing::submit(const Allocation& allocation, IssueFunc issue)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (allocation.epoch != m_epoch || !m_mapped)
+            return;
+
+        // nothing will be issued once terminate started, the write only had to finish
+        if (!m_terminating)
+            m_commands.push_back({allocation, std::move(issue)});
+        if (--m_writers == 0)
+            m_writers_done.notify_all();
+    }
+
+    void StagingRing::cancel(const Allocation& allocation)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (allocation.epoch != m_epoch || !m_mapped)
+            return;
+
+        if (--m_writers == 0)
+            m_writers_done.notify_all();
+    }
+
+    bool StagingRing::stageBuffer(GLuint                                buffer,
+                                  size_t                                dst_offset,
+                                  const void*                           data,
+                                  size_t                                size,
+                                  const std::shared_ptr<UploadTracker>& tracker)
+    {
+        Allocation allocation = allocate(size);
+        if (!allocation)
+            return false;
+
+        std::memcpy(allocation.data, data, size);
+
+        if (tracker)
+            ++tracker->pending;
+        submit(allocation, [buffer, dst_offset, tracker](const Allocation& staged, bool data_lost) {
+            if (tracker)
+            {
+                --tracker->pending;
+                if (tracker->released)
+                    return;
+            }
+            if (data_lost)
+                LOG_ERROR("Staged buffer upload lost, buffer " + std::to_string(buffer) + " is undefined");
+
+            glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER,
+                                GL_COPY_WRITE_BUFFER,
+                                static_cast<GLintptr>(staged.offset),
+                                static_cast<GLintptr>(dst_offset),
+                                static_cast<GLsizeiptr>(staged.size));
+        });
+        return true;
+    }
+
+    void StagingRing::update()
+    {
+        m_stats.staged_bytes = 0;
+
+        recycleRegions();
+        closeMapping();
+        openMapping();
+
+        m_stats.in_flight_bytes = 0;
+        for (const Region& region : m_regions)
+            m_stats.in_flight_bytes += region.end - region.begin;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stats.failed_allocations = m_failed_allocations;
+            m_failed_allocations       = 0;
+        }
+    }
+
+    void StagingRing::recycleRegions()
+    {
+        // in submission order, so the first unsignaled fence ends the scan
+        while (!m_regions.empty())
+        {
+            GLenum status = glClientWaitSync(m_regions.front().fence, 0, 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED)
+                break;
+
+            glDeleteSync(m_regions.front().fence);
+            m_regions.pop_front();
+        }
+    }
+
+    /**
+     * @brief unmap and issue everything written into the open mapping
+     *
+     * Skipped while a writer is still filling its allocation, the mapping then stays open for
+     * another frame. Nothing is waited on.
+     */
+    void StagingRing::closeMapping()
+    {
+        size_t               begin = 0;
+        size_t               end   = 0;
+        std::vector<Command> commands;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_mapped || m_writers > 0 || m_write == m_map_begin)
+                return;
+
+            begin = m_map_begin;
+            end   = m_write;
+            commands.swap(m_commands);
+            m_mapped = nullptr;
+            ++m_epoch;
+        }
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+        glFlushMappedBufferRange(GL_COPY_WRITE_BUFFER, 0, static_cast<GLsizeiptr>(end - begin));
+        bool data_lost = glUnmapBuffer(GL_COPY_WRITE_BUFFER) == GL_FALSE;
+        if (data_lost)
+            LOG_WARN("StagingRing mapping was lost, " + std::to_string(commands.size()) + " uploads lost their data");
+
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_buffer);
+        glBindBuffer(GL_COPY_READ_BUFFER, m_buffer);
+        for (Command& command : commands)
+            command.issue(command.allocation, data_lost);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        m_regions.push_back({begin, end, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0)});
+        m_stats.staged_bytes = end - begin;
+    }
+
+    // map the largest free span, the ring is written front to back and wraps to 0
+    void StagingRing::openMapping()
+    {
+        if (m_mapped)
+            return;
+
+        size_t begin = 0;
+        size_t end   = m_size;
+        if (!m_regions.empty())
+        {
+            size_t head = m_regions.back().end;
+            size_t tail = m_regions.front().begin;
+            if (m_regions.back().begin >= tail)
+            {
+                // in flight regions are contiguous, free space is after them and before them
+                begin = head;
+                end   = m_size;
+                if (tail > m_size - head)
+                {
+                    begin = 0;
+                    end   = tail;
+                }
+            }
+            else
+            {
+                // wrapped, free space is between the newest and the oldest region
+                begin = head;
+                end   = tail;
+            }
+        }
+
+        if (end - begin < std::min(m_MIN_MAP_SIZE, m_size))
+            return;
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+        // unsynchronized: nothing the gpu reads lies in this span, so the driver must not wait for it
+        void* mapped = glMapBufferRange(GL_COPY_WRITE_BUFFER,
+                                        static_cast<GLintptr>(begin),
+                                        static_cast<GLsizeiptr>(end - begin),
+                                        GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT |
+                                            GL_MAP_FLUSH_EXPLICIT_BIT);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        if (!mapped)
+        {
+            LOG_ERROR("StagingRing could not map " + std::to_string(end - begin) + " bytes");
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_mapped    = static_cast<std::byte*>(mapped);
+        m_map_begin = begin;
+        m_map_end   = end;
+        m_write     = begin;
+    }
+} // namespace RealmEngine
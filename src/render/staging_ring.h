@@ -0,0 +1,130 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/gl.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace RealmEngine
+{
+    // shared between an owner of gpu buffers and its staged copies, which skip destinations released before they ran
+    struct UploadTracker
+    {
+        std::atomic<uint32_t> pending {0};
+        std::atomic<bool>     released {false};
+    };
+
+    /**
+     * @brief pixel/copy source buffer that texture and buffer uploads are staged through
+     *
+     * GL 3.3 has no persistent mapping, so once per frame the ring maps its largest free region
+     * (unsynchronized, nothing the gpu still reads is in it). Any thread may then carve allocations out
+     * of that mapping, write into them and submit a command. On the next update() where no write is in
+     * progress, the GL thread unmaps, runs the submitted commands with the ring bound as
+     * GL_PIXEL_UNPACK_BUFFER / GL_COPY_READ_BUFFER and fences the region. The region is reused once
+     * its fence signals, which is polled and never waited on.
+     */
+    class StagingRing
+    {
+    public:
+        struct Allocation
+        {
+            std::byte* data {nullptr};
+            size_t     offset {0}; // in the ring buffer, what gl calls take as the source
+            size_t     size {0};
+            uint64_t   epoch {0};
+
+            explicit operator bool() const { return data != nullptr; }
+        };
+
+        // GL thread, ring bound for unpack and copy-read. data_lost: the driver discarded the mapping contents
+        using IssueFunc = std::function<void(const Allocation& allocation, bool data_lost)>;
+
+        struct Stats
+        {
+            size_t   capacity {0};
+            size_t   in_flight_bytes {0}; // fenced regions the gpu may still read
+            size_t   staged_bytes {0};    // issued last update
+            uint32_t failed_allocations {0};
+        };
+
+        void initialize(size_t size = m_DEFAULT_SIZE);
+        void terminate();
+
+        // any thread, empty if the current mapping has no room; the caller falls back or retries later
+        Allocation allocate(size_t size, size_t alignment = m_ALIGNMENT);
+
+        // any thread, allocation is fully written, issue runs on the GL thread at a later update()
+        void submit(const Allocation& allocation, IssueFunc issue);
+        // any thread, allocation will not be written after all
+        void cancel(const Allocation& allocation);
+
+        /**
+         * @brief any thread: copy data into buffer at dst_offset through the ring
+         *
+         * False if the ring is full, nothing is queued then. tracker (optional) counts the copy as pending
+         * until it ran, set its released flag before deleting buffer.
+         */
+        bool stageBuffer(GLuint                                buffer,
+                         size_t                                dst_offset,
+                         const void*                           data,
+                         size_t                                size,
+                         const std::shared_ptr<UploadTracker>& tracker = {});
+
+        // GL thread, once per frame before anything depends on staged data
+        void update();
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        struct Command
+        {
+            Allocation allocation;
+            IssueFunc  issue;
+        };
+
+        struct Region
+        {
+            size_t begin;
+            size_t end;
+            GLsync fence;
+        };
+
+        static constexpr size_t m_DEFAULT_SIZE = size_t(32) << 20;
+        static constexpr size_t m_ALIGNMENT    = 16;
+        // smaller free regions are not worth a map, wait for fences instead
+        static constexpr size_t m_MIN_MAP_SIZE = size_t(256) << 10;
+
+        GLuint             m_buffer {0};
+        size_t             m_size {0};
+        std::deque<Region> m_regions; // fenced, oldest first
+
+        // the open mapping, guarded by m_mutex since allocate/submit run on any thread
+        std::mutex              m_mutex;
+        std::condition_variable m_writers_done; // terminate() waits on it before unmapping
+        std::byte*              m_mapped {nullptr};
+        size_t                  m_map_begin {0};
+        size_t                  m_map_end {0};
+        size_t                  m_write {0};
+        uint32_t                m_writers {0};
+        uint64_t                m_epoch {0};
+        bool                    m_terminating {false};
+        std::vector<Command>    m_commands;
+
+        Stats    m_stats;
+        uint32_t m_failed_allocations {0}; // since last update, under m_mutex
+
+        void recycleRegions();
+        void closeMapping();
+        void openMapping();
+    };
+} // namespace RealmEngine
@@ -2,16 +2,22 @@
 #include "global.h"
 #include "logger.h"
 
+#include <functional>
+
 namespace RealmEngine
 {
     void StateManager::initialize()
     {
-        // store default state
-        m_current_state = State {};
-        applyState(m_current_state);
+        // default state is always id 0, first bind sends everything
+        m_pipeline_states.clear();
+        m_pipeline_state_lookup.clear();
+        m_gl_state_valid = false;
+        createPipelineState(State {});
+        bindPipelineState(m_DEFAULT_PIPELINE_STATE);
 
         // get limits for current OpenGL device
-        glGetIntegerv(GL_MAX_TEXTURE_UNITS, &m_limit.texture_unit_max);
+        // GL_MAX_TEXTURE_UNITS is fixed-function only and reads 0 in a core profile
+        glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &m_limit.texture_unit_max);
         glGetIntegerv(GL_MAX_UNIFORM_BUFFER_BINDINGS, &m_limit.uniform_buffer_max);
 
         LOG_INFO("StateManager initialized");
@@ -19,8 +25,9 @@ namespace RealmEngine
 
     void StateManager::terminate()
     {
-        while (!m_state_stack.empty())
-            m_state_stack.pop();
+        m_pipeline_states.clear();
+        m_pipeline_state_lookup.clear();
+        m_bound_state = m_INVALID_PIPELINE_STATE;
 
         unbindAllTexture();
         unbindAllUBOs();
@@ -29,21 +36,94 @@ namespace RealmEngine
         LOG_INFO("StateManager terminated");
     }
 
-    void StateManager::pushState(const State& state)
+    bool StateManager::State::operator==(const State& other) const
+    {
+        return polygon_mode == other.polygon_mode && line_width == other.line_width &&
+               point_size == other.point_size && color_write == other.color_write &&
+               enable_depth_test == other.enable_depth_test && depth_func == other.depth_func &&
+               depth_write == other.depth_write && blending == other.blending && src_blend == other.src_blend &&
+               dst_blend == other.dst_blend && enable_culling == other.enable_culling &&
+               cull_face == other.cull_face && front_face == other.front_face && enable_msaa == other.enable_msaa;
+    }
+
+    size_t StateManager::StateHash::operator()(const State& state) const
     {
-        m_state_stack.push(m_current_state);
-        m_current_state = state;
-        applyState(m_current_state);
+        size_t seed    = 0;
+        auto   combine = [&seed](size_t value) { seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2); };
+
+        combine(std::hash<GLenum> {}(state.polygon_mode));
+        combine(std::hash<float> {}(state.line_width));
+        combine(std::hash<float> {}(state.point_size));
+        combine(std::hash<GLenum> {}(state.depth_func));
+        combine(std::hash<GLenum> {}(state.src_blend));
+        combine(std::hash<GLenum> {}(state.dst_blend));
+        combine(std::hash<GLenum> {}(state.cull_face));
+        combine(std::hash<GLenum> {}(state.front_face));
+
+        // all toggles in one word
+        size_t flags = (state.color_write ? 1u : 0u) | (state.enable_depth_test ? 2u : 0u) |
+                       (state.depth_write ? 4u : 0u) | (state.blending ? 8u : 0u) |
+                       (state.enable_culling ? 16u : 0u) | (state.enable_msaa ? 32u : 0u);
+        combine(flags);
+
+        return seed;
     }
 
-    void StateManager::popState()
+    /**
+     * @brief validate and intern a pipeline state
+     *
+     * @param state full render state, copied and never modified afterwards
+     * @return id to pass to bindPipelineState, the default state's id if validation fails
+     */
+    StateManager::PipelineStateId StateManager::createPipelineState(const State& state)
     {
-        if (!m_state_stack.empty())
+        auto it = m_pipeline_state_lookup.find(state);
+        if (it != m_pipeline_state_lookup.end())
+            return it->second;
+
+        if (!validateState(state))
         {
-            m_current_state = m_state_stack.top();
-            m_state_stack.pop();
-            applyState(m_current_state);
+            LOG_ERROR("Invalid pipeline state, falling back to default state");
+            return m_DEFAULT_PIPELINE_STATE;
         }
+
+        auto id = static_cast<PipelineStateId>(m_pipeline_states.size());
+        m_pipeline_states.push_back(state);
+        m_pipeline_state_lookup.emplace(state, id);
+        return id;
+    }
+
+    /**
+     * @brief make a pipeline state current, rebinding the bound one is a single compare
+     *
+     * @param id id returned by createPipelineState
+     */
+    void StateManager::bindPipelineState(PipelineStateId id)
+    {
+        if (id == m_bound_state)
+            return;
+
+        if (id >= m_pipeline_states.size())
+        {
+            LOG_ERROR("Unknown pipeline state id!!!");
+            return;
+        }
+
+        applyState(m_pipeline_states[id]);
+        m_bound_state = id;
+    }
+
+    bool StateManager::validateState(const State& state)
+    {
+        const bool polygon_mode_ok =
+            state.polygon_mode == GL_FILL || state.polygon_mode == GL_LINE || state.polygon_mode == GL_POINT;
+        const bool depth_func_ok = state.depth_func >= GL_NEVER && state.depth_func <= GL_ALWAYS;
+        const bool cull_face_ok =
+            state.cull_face == GL_BACK || state.cull_face == GL_FRONT || state.cull_face == GL_FRONT_AND_BACK;
+        const bool front_face_ok = state.front_face == GL_CCW || state.front_face == GL_CW;
+        const bool sizes_ok      = state.line_width > 0.0f && state.point_size > 0.0f;
+
+        return polygon_mode_ok && depth_func_ok && cull_face_ok && front_face_ok && sizes_ok;
     }
 
     void StateManager::applyState(const State& state)
@@ -53,6 +133,9 @@ namespace RealmEngine
         applyBlendState(state);
         applyCullState(state);
         applyMiscState(state);
+
+        m_gl_state       = state;
+        m_gl_state_valid = true;
     }
 
     /**
@@ -153,64 +236,74 @@ namespace RealmEngine
         }
     }
 
+    /**
+     * @brief diff one field against the shadowed gl state and count the outcome
+     *
+     * @param changed whether the requested value differs from the shadow
+     * @return true if the gl call has to be issued
+     */
+    bool StateManager::needsUpdate(bool changed)
+    {
+        changed = changed || !m_gl_state_valid;
+        ++(changed ? m_stats.issued_calls : m_stats.skipped_calls);
+        return changed;
+    }
+
     void StateManager::applyRasterState(const State& state)
     {
-        glPolygonMode(GL_FRONT_AND_BACK, state.polygon_mode);
-        glLineWidth(state.line_width);
-        glPointSize(state.point_size);
+        if (needsUpdate(m_gl_state.polygon_mode != state.polygon_mode))
+            glPolygonMode(GL_FRONT_AND_BACK, state.polygon_mode);
+
+        if (needsUpdate(m_gl_state.line_width != state.line_width))
+            glLineWidth(state.line_width);
+
+        if (needsUpdate(m_gl_state.point_size != state.point_size))
+            glPointSize(state.point_size);
+
+        if (needsUpdate(m_gl_state.color_write != state.color_write))
+        {
+            GLboolean color_mask = state.color_write ? GL_TRUE : GL_FALSE;
+            glColorMask(color_mask, color_mask, color_mask, color_mask);
+        }
     }
 
     void StateManager::applyDepthState(const State& state)
     {
-        if (state.enable_depth_test)
-        {
-            glEnable(GL_DEPTH_TEST);
+        if (needsUpdate(m_gl_state.enable_depth_test != state.enable_depth_test))
+            state.enable_depth_test ? glEnable(GL_DEPTH_TEST) : glDisable(GL_DEPTH_TEST);
+
+        if (needsUpdate(m_gl_state.depth_func != state.depth_func))
             glDepthFunc(state.depth_func);
-        }
-        else
-        {
-            glDisable(GL_DEPTH_TEST);
-        }
+
+        // also masks glClear, so it is tracked even while depth test is off
+        if (needsUpdate(m_gl_state.depth_write != state.depth_write))
+            glDepthMask(state.depth_write ? GL_TRUE : GL_FALSE);
     }
 
     void StateManager::applyBlendState(const State& state)
     {
-        if (state.blending)
-        {
-            glEnable(GL_BLEND);
+        if (needsUpdate(m_gl_state.blending != state.blending))
+            state.blending ? glEnable(GL_BLEND) : glDisable(GL_BLEND);
+
+        if (needsUpdate(m_gl_state.src_blend != state.src_blend || m_gl_state.dst_blend != state.dst_blend))
             glBlendFunc(state.src_blend, state.dst_blend);
-        }
-        else
-        {
-            glDisable(GL_BLEND);
-        }
     }
 
     void StateManager::applyCullState(const State& state)
     {
-        if (state.enable_culling)
-        {
-            glEnable(GL_CULL_FACE);
+        if (needsUpdate(m_gl_state.enable_culling != state.enable_culling))
+            state.enable_culling ? glEnable(GL_CULL_FACE) : glDisable(GL_CULL_FACE);
+
+        if (needsUpdate(m_gl_state.cull_face != state.cull_face))
             glCullFace(state.cull_face);
+
+        if (needsUpdate(m_gl_state.front_face != state.front_face))
             glFrontFace(state.front_face);
-        }
-        else
-        {
-            glDisable(GL_CULL_FACE);
-        }
     }
 
     void StateManager::applyMiscState(const State& state)
     {
-        glfwSwapInterval(state.v_sync_interval);
-
-        if (state.enable_msaa)
-        {
-            glEnable(GL_MULTISAMPLE);
-        }
-        else
-        {
-            glDisable(GL_MULTISAMPLE);
-        }
+        if (needsUpdate(m_gl_state.enable_msaa != state.enable_msaa))
+            state.enable_msaa ? glEnable(GL_MULTISAMPLE) : glDisable(GL_MULTISAMPLE);
     }
 } // namespace RealmEngine
\ No newline at end of file
@@ -5,7 +5,10 @@
 #include <glad/gl.h>
 
 #include <array>
-#include <stack>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
 
 namespace RealmEngine
 {
@@ -18,9 +21,11 @@ namespace RealmEngine
             GLenum polygon_mode = GL_FILL;
             float  line_width   = 1.0f;
             float  point_size   = 1.0f;
+            bool   color_write  = true;
             // Depth Testing
             bool   enable_depth_test = true;
             GLenum depth_func        = GL_LESS;
+            bool   depth_write       = true;
             // Blending
             bool   blending  = false;
             GLenum src_blend = GL_SRC_ALPHA;
@@ -30,8 +35,27 @@ namespace RealmEngine
             GLenum cull_face      = GL_BACK;
             GLenum front_face     = GL_CCW;
             // Misc
-            int  v_sync_interval = 1;
-            bool enable_msaa     = true;
+            bool enable_msaa = false; // anti-aliasing is done by TAA
+
+            bool operator==(const State& other) const;
+            bool operator!=(const State& other) const { return !(*this == other); }
+        };
+
+        struct StateHash
+        {
+            size_t operator()(const State& state) const;
+        };
+
+        // handle to an immutable, validated and interned State
+        using PipelineStateId = uint32_t;
+
+        static constexpr PipelineStateId m_DEFAULT_PIPELINE_STATE = 0;
+
+        // gl calls issued / skipped by state diffing since the last resetStats()
+        struct Stats
+        {
+            uint32_t issued_calls {0};
+            uint32_t skipped_calls {0};
         };
 
         void initialize();
@@ -41,8 +65,19 @@ namespace RealmEngine
         bool   isUBOBound(GLuint binding_point) const { return m_binding.bound_ubos[binding_point] != 0; }
         bool   isTextureBound(GLuint unit) const { return m_binding.bound_textures[unit] != 0; }
 
-        void pushState(const State& state);
-        void popState();
+        // create once (e.g. in a pass constructor), identical states share one id
+        PipelineStateId createPipelineState(const State& state);
+        void            bindPipelineState(PipelineStateId id);
+
+        // call after raw gl state changes outside the manager, next bind re-sends everything
+        void invalidateState()
+        {
+            m_gl_state_valid = false;
+            m_bound_state    = m_INVALID_PIPELINE_STATE;
+        }
+
+        const Stats& getStats() const { return m_stats; }
+        void         resetStats() { m_stats = Stats {}; }
 
         void bindTexture(int unit, GLuint texture, GLenum target = GL_TEXTURE_2D);
         void bindUBO(GLuint ubo, int binding_point);
@@ -66,9 +101,19 @@ namespace RealmEngine
             int uniform_buffer_max {0};
         } m_limit;
 
-        std::stack<State> m_state_stack;
-        State             m_current_state;
+        static constexpr PipelineStateId m_INVALID_PIPELINE_STATE = UINT32_MAX;
+
+        std::vector<State>                                    m_pipeline_states;
+        std::unordered_map<State, PipelineStateId, StateHash> m_pipeline_state_lookup;
+        PipelineStateId                                       m_bound_state {m_INVALID_PIPELINE_STATE};
+
+        State m_gl_state; // shadow of what the driver currently has
+        bool  m_gl_state_valid {false};
+        Stats m_stats;
+
+        static bool validateState(const State& state);
 
+        bool needsUpdate(bool changed);
         void applyState(const State& state);
         void applyRasterState(const State& state);
         void applyDepthState(const State& state);
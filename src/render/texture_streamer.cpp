@@ -0,0 +1,672 @@
+#include "texture_streamer.h"
+#include "global.h"
+#include "logger.h"
+#include "render/state.h"
+#include "resource/vfs.h"
+
+#include <stb_image.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+
+namespace RealmEngine
+{
+    namespace
+    {
+        GLenum getFormat(int channels) { return channels == 1 ? GL_RED : channels == 3 ? GL_RGB : GL_RGBA; }
+        GLint  getInternalFormat(int channels) { return channels == 1 ? GL_R8 : channels == 3 ? GL_RGB8 : GL_RGBA8; }
+
+        uint32_t getLevelSize(uint32_t size, uint32_t level) { return std::max(size >> level, 1u); }
+
+        // 2x2 box filter, odd edges repeat their last texel
+        void downsample(const std::vector<unsigned char>& src,
+                        uint32_t                          width,
+                        uint32_t                          height,
+                        int                               channels,
+                        std::vector<unsigned char>&       dst)
+        {
+            uint32_t dst_width  = std::max(width / 2, 1u);
+            uint32_t dst_height = std::max(height / 2, 1u);
+            dst.resize(static_cast<size_t>(dst_width) * dst_height * channels);
+
+            for (uint32_t y = 0; y < dst_height; ++y)
+            {
+                uint32_t y0 = std::min(y * 2, height - 1);
+                uint32_t y1 = std::min(y * 2 + 1, height - 1);
+                for (uint32_t x = 0; x < dst_width; ++x)
+                {
+                    uint32_t x0 = std::min(x * 2, width - 1);
+                    uint32_t x1 = std::min(x * 2 + 1, width - 1);
+                    for (int c = 0; c < channels; ++c)
+                    {
+                        uint32_t sum = src[(static_cast<size_t>(y0) * width + x0) * channels + c] +
+                                       src[(static_cast<size_t>(y0) * width + x1) * channels + c] +
+                                       src[(static_cast<size_t>(y1) * width + x0) * channels + c] +
+                                       src[(static_cast<size_t>(y1) * width + x1) * channels + c];
+                        dst[(static_cast<size_t>(y) * dst_width + x) * channels + c] =
+                            static_cast<unsigned char>((sum + 2) / 4);
+                    }
+                }
+            }
+        }
+    } // namespace
+
+    void TextureStreamer::initialize(StateManager* state_mgr, StagingRing* staging_ring)
+    {
+        m_state_mgr    = state_mgr;
+        m_staging_ring = staging_ring;
+        m_completed    = std::make_shared<CompletedLoads>();
+
+        LOG_INFO("TextureStreamer initialized, budget " + std::to_string(m_budget >> 20) + " MB");
+    }
+
+    void TextureStreamer::terminate()
+    {
+        for (const auto& [id, entry] : m_textures)
+            glDeleteTextures(1, &id);
+
+        // loads still running finish into the shared queue and are dropped with it
+        m_textures.clear();
+        m_uploads.clear();
+        m_completed.reset();
+        m_resident_bytes  = 0;
+        m_pending_bytes   = 0;
+        m_loads_in_flight = 0;
+        m_staging_ring    = nullptr;
+
+        LOG_INFO("TextureStreamer terminated");
+    }
+
+    size_t TextureStreamer::getLevelBytes(const Entry& entry, uint32_t level)
+    {
+        // drivers pad rgb8 to four bytes per texel
+        size_t texel_bytes = entry.channels == 1 ? 1 : 4;
+        return static_cast<size_t>(getLevelSize(entry.width, level)) * getLevelSize(entry.height, level) *
+               texel_bytes;
+    }
+
+    size_t TextureStreamer::getLevelRangeBytes(const Entry& entry, uint32_t first, uint32_t end)
+    {
+        size_t bytes = 0;
+        for (uint32_t level = first; level < end; ++level)
+            bytes += getLevelBytes(entry, level);
+        return bytes;
+    }
+
+    size_t TextureStreamer::getStagedBytes(const Entry& entry, uint32_t first, uint32_t end)
+    {
+        size_t bytes = 0;
+        for (uint32_t level = first; level < end; ++level)
+            bytes += static_cast<size_t>(getLevelSize(entry.width, level)) * getLevelSize(entry.height, level) *
+                     entry.channels;
+        return bytes;
+    }
+
+    void TextureStreamer::bindForUpdate(GLuint id)
+    {
+        // through the state manager so its binding cache stays right, the bind skips glActiveTexture if cached
+        m_state_mgr->bindTexture(0, id);
+        glActiveTexture(GL_TEXTURE0);
+    }
+
+    void TextureStreamer::uploadLevel(const Entry& entry, uint32_t level, const unsigned char* pixels)
+    {
+        glTexImage2D(GL_TEXTURE_2D,
+                     static_cast<GLint>(level),
+                     getInternalFormat(entry.channels),
+                     static_cast<GLsizei>(getLevelSize(entry.width, level)),
+                     static_cast<GLsizei>(getLevelSize(entry.height, level)),
+                     0,
+                     getFormat(entry.channels),
+                     GL_UNSIGNED_BYTE,
+                     pixels);
+    }
+
+    // levels [first, end) packed in order at offset of the bound pixel unpack buffer
+    void TextureStreamer::uploadStagedLevels(const Entry& entry, uint32_t first, uint32_t end, size_t offset)
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        for (uint32_t level = first; level < end; ++level)
+        {
+            uploadLevel(entry, level, reinterpret_cast<const unsigned char*>(offset));
+            offset += getStagedBytes(entry, level, level + 1);
+        }
+    }
+
+    GLuint TextureStreamer::createTexture(const std::string&   path,
+                                          const unsigned char* pixels,
+                                          int                  width,
+                                          int                  height,
+                                          int                  channels)
+    {
+        if (!pixels || width <= 0 || height <= 0 || (channels != 1 && channels != 3 && channels != 4))
+        {
+            LOG_ERROR("Unsupported texture " + path + " (" + std::to_string(channels) + " channels)");
+            return 0;
+        }
+
+        Entry entry;
+        entry.path        = path;
+        entry.channels    = channels;
+        entry.width       = static_cast<uint32_t>(width);
+        entry.height      = static_cast<uint32_t>(height);
+        entry.level_count = static_cast<uint32_t>(std::floor(std::log2(std::max(width, height)))) + 1;
+        while (entry.min_resident_level + 1 < entry.level_count &&
+               std::max(getLevelSize(entry.width, entry.min_resident_level),
+                        getLevelSize(entry.height, entry.min_resident_level)) > m_INITIAL_MAX_SIZE)
+            ++entry.min_resident_level;
+        entry.resident_level  = entry.min_resident_level;
+        entry.wanted_level    = entry.min_resident_level;
+        entry.requested_level = entry.level_count;
+        entry.serial          = ++m_next_serial;
+
+        // permanent levels are written into the ring and uploaded from there at its next update,
+        // until then nothing is resident and they count as pending
+        StagingRing::Allocation staged;
+        if (m_staging_ring)
+            staged = m_staging_ring->allocate(getStagedBytes(entry, entry.min_resident_level, entry.level_count));
+        if (staged)
+            entry.resident_level = entry.level_count;
+
+        GLuint id = 0;
+        glGenTextures(1, &id);
+        bindForUpdate(id);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(entry.resident_level));
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(entry.level_count - 1));
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        // the full chain is built once here, only the coarse tail is uploaded
+        std::vector<unsigned char> level_pixels(pixels, pixels + static_cast<size_t>(width) * height * channels);
+        std::vector<unsigned char> next_pixels;
+        size_t                     staged_offset = 0;
+        for (uint32_t level = 0; level < entry.level_count; ++level)
+        {
+            if (level > 0)
+            {
+                downsample(level_pixels,
+                           getLevelSize(entry.width, level - 1),
+                           getLevelSize(entry.height, level - 1),
+                           channels,
+                           next_pixels);
+                level_pixels.swap(next_pixels);
+            }
+
+            if (level < entry.min_resident_level)
+                continue;
+
+            if (staged)
+            {
+                std::memcpy(staged.data + staged_offset, level_pixels.data(), level_pixels.size());
+                staged_offset += level_pixels.size();
+            }
+            else
+            {
+                uploadLevel(entry, level, level_pixels.data());
+                m_resident_bytes += getLevelBytes(entry, level);
+            }
+        }
+
+        if (staged)
+        {
+            // loading keeps streaming and eviction away until the levels exist
+            uint64_t serial = entry.serial;
+            uint32_t first  = entry.min_resident_level;
+            uint32_t end    = entry.level_count;
+            entry.loading       = true;
+            entry.pending_bytes = getLevelRangeBytes(entry, first, end);
+            m_pending_bytes += entry.pending_bytes;
+
+            auto finish = [this, id, serial, first, end](const StagingRing::Allocation& block, bool lost) {
+                auto it = m_textures.find(id);
+                if (it == m_textures.end() || it->second.serial != serial)
+                    return;
+
+                Entry& staged_entry = it->second;
+                m_pending_bytes -= staged_entry.pending_bytes;
+                staged_entry.pending_bytes = 0;
+                staged_entry.loading       = false;
+
+                // nothing is resident, so the next startLoads() decodes the levels again from the file
+                if (lost)
+                {
+                    LOG_WARN("Staged upload of texture " + staged_entry.path + " was lost, reloading it");
+                    staged_entry.unstaged = true;
+                    return;
+                }
+
+                bindForUpdate(id);
+                uploadStagedLevels(staged_entry, first, end, block.offset);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(first));
+
+                staged_entry.resident_level = first;
+                m_resident_bytes += getLevelRangeBytes(staged_entry, first, end);
+                m_uploaded_levels += end - first;
+            };
+            m_staging_ring->submit(staged, finish);
+        }
+
+        m_textures.emplace(id, std::move(entry));
+        return id;
+    }
+
+    void TextureStreamer::destroyTexture(GLuint id)
+    {
+        auto it = m_textures.find(id);
+        if (it == m_textures.end())
+            return;
+
+        // a load still in flight finds no entry and is dropped
+        m_resident_bytes -= getLevelRangeBytes(it->second, it->second.resident_level, it->second.level_count);
+        m_pending_bytes -= it->second.pending_bytes;
+        m_textures.erase(it);
+        glDeleteTextures(1, &id);
+    }
+
+    bool TextureStreamer::isUploaded(GLuint id) const
+    {
+        // permanent levels are never evicted, so only a pending first upload leaves them missing
+        auto it = m_textures.find(id);
+        return it == m_textures.end() || it->second.failed ||
+               it->second.resident_level <= it->second.min_resident_level;
+    }
+
+    void TextureStreamer::requestSize(GLuint id, float screen_pixels)
+    {
+        auto it = m_textures.find(id);
+        if (it == m_textures.end())
+            return;
+
+        // one texel per pixel, the texture is assumed to span the object once
+        Entry&   entry = it->second;
+        uint32_t level = entry.level_count - 1;
+        if (screen_pixels > 1.0f)
+        {
+            float texels_per_pixel = static_cast<float>(std::max(entry.width, entry.height)) / screen_pixels;
+            level = texels_per_pixel <= 1.0f ? 0u : static_cast<uint32_t>(std::floor(std::log2(texels_per_pixel)));
+        }
+
+        entry.requested_level = std::min({entry.requested_level, level, entry.level_count - 1});
+    }
+
+    void TextureStreamer::update()
+    {
+        ++m_frame;
+
+        for (auto& [id, entry] : m_textures)
+        {
+            // not drawn, want nothing beyond the permanent levels so LRU eviction is not streamed straight back
+            if (entry.requested_level >= entry.level_count)
+            {
+                entry.wanted_level = entry.min_resident_level;
+                continue;
+            }
+
+            entry.wanted_level    = std::min(entry.requested_level, entry.min_resident_level);
+            entry.last_used_frame = m_frame;
+            entry.requested_level = entry.level_count;
+        }
+
+        collectLoads();
+        uploadLoads();
+        startLoads();
+
+        if (m_resident_bytes > m_budget)
+            evict(m_resident_bytes - m_budget);
+
+        m_stats.resident_bytes  = m_resident_bytes;
+        m_stats.pending_bytes   = m_pending_bytes;
+        m_stats.texture_count   = static_cast<uint32_t>(m_textures.size());
+        m_stats.uploaded_levels = m_uploaded_levels;
+        m_stats.evicted_levels  = m_evicted_levels;
+        m_stats.streaming_count = 0;
+        m_uploaded_levels       = 0;
+        m_evicted_levels        = 0;
+        for (const auto& [id, entry] : m_textures)
+        {
+            if (entry.wanted_level < entry.resident_level && !entry.failed)
+                ++m_stats.streaming_count;
+        }
+    }
+
+    void TextureStreamer::collectLoads()
+    {
+        std::vector<LoadedLevels> loads;
+        {
+            std::lock_guard<std::mutex> lock(m_completed->mutex);
+            loads.swap(m_completed->loads);
+        }
+
+        for (LoadedLevels& load : loads)
+        {
+            --m_loads_in_flight;
+            m_uploads.push_back(std::move(load));
+        }
+    }
+
+    /**
+     * @brief upload finished loads coarse to fine until this frame's upload budget is spent
+     *
+     * A level becomes visible (base level lowered) as soon as it is uploaded, so a large texture
+     * sharpens over a few frames instead of stalling one. A level that does not fit in what is left of
+     * the budget is defined empty, then filled in row bands across frames and only shown once complete.
+     */
+    void TextureStreamer::uploadLoads()
+    {
+        size_t uploaded = 0;
+        while (!m_uploads.empty() && uploaded < m_upload_budget)
+        {
+            // destroyed while loading, and maybe its name handed to a new texture since
+            LoadedLevels& load = m_uploads.front();
+            auto          it   = m_textures.find(load.id);
+            if (it == m_textures.end() || it->second.serial != load.serial)
+            {
+                m_uploads.pop_front();
+                continue;
+            }
+
+            Entry&   entry = it->second;
+            uint32_t end   = load.first_level + static_cast<uint32_t>(load.levels.size());
+
+            // evicted in the meantime, failed to decode, or nothing left to do
+            if (load.levels.empty() || entry.resident_level == 0 || entry.resident_level > end ||
+                entry.resident_level <= load.first_level)
+            {
+                if (load.levels.empty())
+                    entry.failed = true;
+                m_pending_bytes -= entry.pending_bytes;
+                entry.pending_bytes = 0;
+                entry.loading       = false;
+                m_uploads.pop_front();
+                continue;
+            }
+
+            uint32_t             level     = entry.resident_level - 1;
+            size_t               bytes     = getLevelBytes(entry, level);
+            uint32_t             width     = getLevelSize(entry.width, level);
+            uint32_t             height    = getLevelSize(entry.height, level);
+            size_t               row_bytes = static_cast<size_t>(width) * entry.channels;
+            const unsigned char* pixels    = load.levels[level - load.first_level].data();
+            size_t               available = m_upload_budget - uploaded;
+
+            bindForUpdate(load.id);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            if (load.uploaded_rows == 0 && row_bytes * height <= available)
+            {
+                uploadLevel(entry, level, pixels);
+                uploaded += row_bytes * height;
+            }
+            else
+            {
+                if (load.uploaded_rows == 0)
+                    uploadLevel(entry, level, nullptr);
+
+                uint32_t rows = static_cast<uint32_t>(
+                    std::clamp<size_t>(available / row_bytes, 1, height - load.uploaded_rows));
+                glTexSubImage2D(GL_TEXTURE_2D,
+                                static_cast<GLint>(level),
+                                0,
+                                static_cast<GLint>(load.uploaded_rows),
+                                static_cast<GLsizei>(width),
+                                static_cast<GLsizei>(rows),
+                                getFormat(entry.channels),
+                                GL_UNSIGNED_BYTE,
+                                pixels + load.uploaded_rows * row_bytes);
+                load.uploaded_rows += rows;
+                uploaded += rows * row_bytes;
+
+                // budget spent, the rest of the level follows next frame
+                if (load.uploaded_rows < height)
+                    break;
+                load.uploaded_rows = 0;
+            }
+
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(level));
+            load.levels[level - load.first_level] = {};
+
+            entry.resident_level = level;
+            m_resident_bytes += bytes;
+            m_pending_bytes -= bytes;
+            entry.pending_bytes -= bytes;
+            ++m_uploaded_levels;
+
+            if (level == load.first_level)
+            {
+                entry.loading = false;
+                m_uploads.pop_front();
+            }
+        }
+    }
+
+    void TextureStreamer::startLoads()
+    {
+        // biggest detail deficit first
+        std::vector<std::pair<uint32_t, GLuint>> candidates;
+        for (const auto& [id, entry] : m_textures)
+        {
+            if (!entry.loading && !entry.failed && entry.wanted_level < entry.resident_level)
+                candidates.emplace_back(entry.resident_level - entry.wanted_level, id);
+        }
+        std::sort(candidates.begin(), candidates.end(), std::greater<>());
+
+        for (const auto& [deficit, id] : candidates)
+        {
+            if (m_loads_in_flight >= m_MAX_LOADS_IN_FLIGHT)
+                break;
+
+            Entry& entry = m_textures[id];
+
+            // permanent levels missing after a lost staged upload load regardless of the budget, as in
+            // createTexture(); the model is not drawn until they are back
+            uint32_t permanent = std::min(entry.resident_level, entry.min_resident_level);
+
+            // coarser than wanted if the budget cannot take everything, finer levels follow once memory frees up
+            for (uint32_t first = entry.wanted_level; first < entry.resident_level; ++first)
+            {
+                size_t need  = getLevelRangeBytes(entry, first, permanent);
+                size_t total = m_resident_bytes + m_pending_bytes + need;
+                if (need > 0 && total > m_budget)
+                    evict(total - m_budget);
+                if (need == 0 || m_resident_bytes + m_pending_bytes + need <= m_budget)
+                {
+                    startLoad(id, entry, first);
+                    break;
+                }
+            }
+        }
+    }
+
+    void TextureStreamer::startLoad(GLuint id, Entry& entry, uint32_t first_level)
+    {
+        entry.loading       = true;
+        entry.pending_bytes = getLevelRangeBytes(entry, first_level, entry.resident_level);
+        m_pending_bytes += entry.pending_bytes;
+        ++m_loads_in_flight;
+
+        // decode and filter on a worker, the gl thread only uploads
+        std::shared_ptr<CompletedLoads> completed = m_completed;
+        std::string                     path      = entry.path;
+        int                             channels  = entry.channels;
+        uint32_t                        width     = entry.width;
+        uint32_t                        height    = entry.height;
+        uint32_t                        end_level = entry.resident_level;
+        uint64_t                        serial    = entry.serial;
+        StagingRing*                    staging   = entry.unstaged ? nullptr : m_staging_ring;
+        TextureStreamer*                streamer  = this;
+        g_context.m_jobs->submit([=]() {
+            LoadedLevels load;
+            load.id          = id;
+            load.serial      = serial;
+            load.first_level = first_level;
+
+            FileData       file;
+            int            file_width = 0, file_height = 0, file_channels = 0;
+            unsigned char* pixels     = nullptr;
+            if (g_context.m_vfs->read(path, file))
+                pixels = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(file.data()),
+                                               static_cast<int>(file.size()),
+                                               &file_width,
+                                               &file_height,
+                                               &file_channels,
+                                               channels);
+
+            if (pixels && static_cast<uint32_t>(file_width) == width && static_cast<uint32_t>(file_height) == height)
+            {
+                std::vector<unsigned char> level_pixels(pixels,
+                                                        pixels + static_cast<size_t>(width) * height * channels);
+                std::vector<unsigned char> next_pixels;
+                for (uint32_t level = 0; level < end_level; ++level)
+                {
+                    if (level > 0)
+                    {
+                        downsample(level_pixels,
+                                   getLevelSize(width, level - 1),
+                                   getLevelSize(height, level - 1),
+                                   channels,
+                                   next_pixels);
+                        level_pixels.swap(next_pixels);
+                    }
+                    if (level >= first_level)
+                        load.levels.push_back(level_pixels);
+                }
+            }
+            else
+            {
+                LOG_WARN("Could not stream texture " + path + ", keeping its resident mips");
+            }
+            stbi_image_free(pixels);
+
+            // straight into the ring if it has room, the copy out of it happens on the gpu
+            StagingRing::Allocation staged;
+            if (staging && !load.levels.empty())
+            {
+                size_t bytes = 0;
+                for (const auto& level : load.levels)
+                    bytes += level.size();
+                staged = staging->allocate(bytes);
+            }
+            if (staged)
+            {
+                size_t offset = 0;
+                for (const auto& level : load.levels)
+                {
+                    std::memcpy(staged.data + offset, level.data(), level.size());
+                    offset += level.size();
+                }
+                staging->submit(staged, [=](const StagingRing::Allocation& allocation, bool data_lost) {
+                    streamer->finishStagedLoad(id, serial, first_level, end_level, allocation.offset, data_lost);
+                });
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(completed->mutex);
+            completed->loads.push_back(std::move(load));
+        });
+    }
+
+    // the ring issues this on the gl thread, all levels of the load become resident at once
+    void TextureStreamer::finishStagedLoad(GLuint   id,
+                                           uint64_t serial,
+                                           uint32_t first_level,
+                                           uint32_t end_level,
+                                           size_t   offset,
+                                           bool     data_lost)
+    {
+        --m_loads_in_flight;
+
+        auto it = m_textures.find(id);
+        if (it == m_textures.end() || it->second.serial != serial)
+            return;
+
+        Entry& entry = it->second;
+        m_pending_bytes -= entry.pending_bytes;
+        entry.pending_bytes = 0;
+        entry.loading       = false;
+
+        // a lost mapping is retried by a later load, through client memory this time
+        if (data_lost)
+            entry.unstaged = true;
+        if (data_lost || entry.resident_level != end_level)
+            return;
+
+        bindForUpdate(id);
+        uploadStagedLevels(entry, first_level, end_level, offset);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(first_level));
+
+        entry.resident_level = first_level;
+        m_resident_bytes += getLevelRangeBytes(entry, first_level, end_level);
+        m_uploaded_levels += end_level - first_level;
+    }
+
+    void TextureStreamer::dropLevel(GLuint id, Entry& entry)
+    {
+        uint32_t level = entry.resident_level;
+
+        // raise the base first so the texture never references the freed level
+        bindForUpdate(id);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, static_cast<GLint>(level + 1));
+        glTexImage2D(GL_TEXTURE_2D,
+                     static_cast<GLint>(level),
+                     getInternalFormat(entry.channels),
+                     0,
+                     0,
+                     0,
+                     getFormat(entry.channels),
+                     GL_UNSIGNED_BYTE,
+                     nullptr);
+
+        entry.resident_level = level + 1;
+        m_resident_bytes -= getLevelBytes(entry, level);
+        ++m_evicted_levels;
+    }
+
+    /**
+     * @brief free at least bytes of mips, or as much as possible, without touching this frame's needs
+     *
+     * First levels finer than their texture wants, then finer levels of textures not drawn this frame,
+     * least recently drawn first. Textures with a load in flight are skipped, their result expects the
+     * current base level. Returns the bytes freed.
+     */
+    size_t TextureStreamer::evict(size_t bytes)
+    {
+        std::vector<std::pair<uint64_t, GLuint>> candidates;
+        for (const auto& [id, entry] : m_textures)
+        {
+            if (!entry.loading && entry.resident_level < entry.min_resident_level)
+                candidates.emplace_back(entry.last_used_frame, id);
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        size_t freed = 0;
+        for (const auto& [last_used, id] : candidates)
+        {
+            Entry& entry = m_textures[id];
+            while (freed < bytes && entry.resident_level < entry.wanted_level)
+            {
+                freed += getLevelBytes(entry, entry.resident_level);
+                dropLevel(id, entry);
+            }
+        }
+
+        for (const auto& [last_used, id] : candidates)
+        {
+            Entry& entry = m_textures[id];
+            if (last_used == m_frame)
+                break;
+
+            while (freed < bytes && entry.resident_level < entry.min_resident_level)
+            {
+                freed += getLevelBytes(entry, entry.resident_level);
+                dropLevel(id, entry);
+            }
+        }
+
+        return freed;
+    }
+} // namespace RealmEngine
@@ -0,0 +1,157 @@
+#pragma once
+
+#define GLFW_INCLUDE_NONE
+#include <GLFW/glfw3.h>
+#include <glad/gl.h>
+
+#include "render/staging_ring.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace RealmEngine
+{
+    class StateManager;
+
+    /**
+     * @brief keeps texture mips resident by on-screen size, under a video memory budget
+     *
+     * Textures are created with only their mips of m_INITIAL_MAX_SIZE and below. Each frame the pipeline
+     * reports how large a texture appears on screen. Finer mips are then decoded again from the source
+     * file on a worker and uploaded coarse to fine, at most the upload budget per frame; larger levels go
+     * up in row bands over several frames. The finest resident level is GL_TEXTURE_BASE_LEVEL. Evicted
+     * levels are redefined as 0x0 images, so the driver frees them and the texture name held by meshes
+     * stays valid. When over budget, levels nothing needs go first, then levels of the least recently
+     * drawn textures. GL thread only.
+     *
+     * With a StagingRing, workers write decoded levels straight into it and the ring uploads them from
+     * there without a client memory copy, so they bypass the per-frame upload budget. Loads that do not fit
+     * in the ring take the client memory path, and so does any texture whose staged data the driver lost.
+     */
+    class TextureStreamer
+    {
+    public:
+        struct Stats
+        {
+            size_t   resident_bytes {0};
+            size_t   pending_bytes {0}; // decoding or waiting for upload
+            uint32_t texture_count {0};
+            uint32_t streaming_count {0}; // textures below the detail they want
+            uint32_t uploaded_levels {0}; // this frame
+            uint32_t evicted_levels {0};  // this frame
+        };
+
+        void initialize(StateManager* state_mgr, StagingRing* staging_ring = nullptr);
+        void terminate();
+
+        /**
+         * @brief create a streamed texture from decoded level 0 pixels (1, 3 or 4 channels)
+         *
+         * path is read again through the vfs whenever finer levels are streamed in. Returns 0 on failure.
+         */
+        GLuint createTexture(const std::string& path, const unsigned char* pixels, int width, int height, int channels);
+        void   destroyTexture(GLuint id);
+
+        // the permanent mips are on the gpu (or could not be loaded), false while they are still staged
+        bool isUploaded(GLuint id) const;
+
+        // the texture spans about this many pixels on screen this frame, once per draw is fine
+        void requestSize(GLuint id, float screen_pixels);
+
+        // start loads, upload finished ones and evict over budget, once per frame before drawing
+        void update();
+
+        void   setBudget(size_t bytes) { m_budget = bytes; }
+        size_t getBudget() const { return m_budget; }
+        void   setUploadBudget(size_t bytes_per_frame) { m_upload_budget = bytes_per_frame; }
+
+        const Stats& getStats() const { return m_stats; }
+
+    private:
+        struct Entry
+        {
+            std::string path;
+            int         channels {4};
+            uint32_t    width {0};
+            uint32_t    height {0};
+            uint32_t    level_count {1};
+            uint32_t    min_resident_level {0}; // coarse levels from here on are never evicted
+            uint32_t    resident_level {0};     // finest resident level, GL_TEXTURE_BASE_LEVEL
+            uint32_t    wanted_level {0};       // from this frame's requests, min_resident_level if not drawn
+            uint32_t    requested_level {0};    // this frame's finest request, level_count if none
+            uint64_t    last_used_frame {0};
+            size_t      pending_bytes {0}; // of the load in flight
+            uint64_t    serial {0};        // tells a recycled texture name apart in staged uploads
+            bool        loading {false};
+            bool        failed {false};   // source unreadable or changed, keep what is resident
+            bool        unstaged {false}; // the ring lost data of it once, load through client memory
+        };
+
+        // levels decoded on a worker, levels[i] is mip first_level + i
+        struct LoadedLevels
+        {
+            GLuint                                  id {0};
+            uint64_t                                serial {0}; // Entry::serial, the name may be recycled since
+            uint32_t                                first_level {0};
+            uint32_t                                uploaded_rows {0}; // of the level in progress, see uploadLoads
+            std::vector<std::vector<unsigned char>> levels;
+        };
+
+        // shared with load jobs, so a job finishing after terminate() writes into memory it keeps alive
+        struct CompletedLoads
+        {
+            std::mutex                mutex;
+            std::vector<LoadedLevels> loads;
+        };
+
+        // always resident, small enough that every texture can afford it
+        static constexpr uint32_t m_INITIAL_MAX_SIZE    = 64;
+        static constexpr uint32_t m_MAX_LOADS_IN_FLIGHT = 4;
+        static constexpr size_t   m_DEFAULT_BUDGET      = size_t(256) << 20;
+        static constexpr size_t   m_DEFAULT_UPLOAD      = size_t(4) << 20;
+
+        StateManager*                     m_state_mgr {nullptr};
+        StagingRing*                      m_staging_ring {nullptr};
+        std::unordered_map<GLuint, Entry> m_textures;
+        std::deque<LoadedLevels>          m_uploads; // finished loads, uploaded in order
+        std::shared_ptr<CompletedLoads>   m_completed;
+        size_t                            m_budget {m_DEFAULT_BUDGET};
+        size_t                            m_upload_budget {m_DEFAULT_UPLOAD};
+        size_t                            m_resident_bytes {0};
+        size_t                            m_pending_bytes {0};
+        uint32_t                          m_loads_in_flight {0};
+        uint64_t                          m_frame {0};
+        uint64_t                          m_next_serial {0};
+        // counted since the last update, staged uploads land before update runs
+        uint32_t                          m_uploaded_levels {0};
+        uint32_t                          m_evicted_levels {0};
+        Stats                             m_stats;
+
+        static size_t getLevelBytes(const Entry& entry, uint32_t level);
+        static size_t getLevelRangeBytes(const Entry& entry, uint32_t first, uint32_t end);
+        // tightly packed source pixels of levels [first, end)
+        static size_t getStagedBytes(const Entry& entry, uint32_t first, uint32_t end);
+
+        void   bindForUpdate(GLuint id);
+        void   uploadLevel(const Entry& entry, uint32_t level, const unsigned char* pixels);
+        void   uploadStagedLevels(const Entry& entry, uint32_t first, uint32_t end, size_t offset);
+        void   finishStagedLoad(GLuint   id,
+                                uint64_t serial,
+                                uint32_t first_level,
+                                uint32_t end_level,
+                                size_t   offset,
+                                bool     data_lost);
+        void   dropLevel(GLuint id, Entry& entry);
+        void   collectLoads();
+        void   uploadLoads();
+        void   startLoads();
+        void   startLoad(GLuint id, Entry& entry, uint32_t first_level);
+        size_t evict(size_t bytes);
+    };
+} // namespace RealmEngine
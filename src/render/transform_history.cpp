@@ -0,0 +1,77 @@
+#include "transform_history.h"
+#include "global.h"
+#include "logger.h"
+
+namespace RealmEngine
+{
+    RenderObjectHandle TransformHistory::allocate()
+    {
+        if (!m_free_handles.empty())
+        {
+            RenderObjectHandle handle = m_free_handles.back();
+            m_free_handles.pop_back();
+            m_allocated[handle] = true;
+            return handle;
+        }
+
+        auto handle = static_cast<RenderObjectHandle>(m_last_update.size());
+        m_matrices[0].emplace_back(1.0f);
+        m_matrices[1].emplace_back(1.0f);
+        m_last_update.push_back(0);
+        m_allocated.push_back(true);
+        return handle;
+    }
+
+    void TransformHistory::release(RenderObjectHandle handle)
+    {
+        if (handle == g_invalid_render_object)
+            return;
+        if (handle >= m_last_update.size() || !m_allocated[handle])
+        {
+            LOG_ERROR("Invalid render object handle " + std::to_string(handle));
+            return;
+        }
+
+        // forget history so a reused handle does not inherit old motion
+        m_last_update[handle] = 0;
+        m_allocated[handle]   = false;
+        m_free_handles.push_back(handle);
+    }
+
+    const glm::mat4& TransformHistory::update(RenderObjectHandle handle, const glm::mat4& model_matrix)
+    {
+        if (handle >= m_last_update.size() || !m_allocated[handle])
+        {
+            LOG_ERROR("Invalid render object handle " + std::to_string(handle));
+            return model_matrix;
+        }
+
+        const uint32_t previous = m_current ^ 1u;
+
+        m_matrices[m_current][handle] = model_matrix;
+
+        // not drawn last frame (new, or was hidden), no motion to report
+        if (m_last_update[handle] != m_frame && m_last_update[handle] != m_frame - 1)
+            m_matrices[previous][handle] = model_matrix;
+
+        m_last_update[handle] = m_frame;
+        return m_matrices[previous][handle];
+    }
+
+    void TransformHistory::nextFrame()
+    {
+        m_current ^= 1u;
+        ++m_frame;
+    }
+
+    void TransformHistory::clear()
+    {
+        m_matrices[0].clear();
+        m_matrices[1].clear();
+        m_last_update.clear();
+        m_allocated.clear();
+        m_free_handles.clear();
+        m_current = 0;
+        m_frame   = 1;
+    }
+} // namespace RealmEngine
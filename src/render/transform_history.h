@@ -0,0 +1,40 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace RealmEngine
+{
+    using RenderObjectHandle = uint32_t;
+
+    static constexpr RenderObjectHandle g_invalid_render_object = UINT32_MAX;
+
+    /**
+     * @brief last-frame model matrices for motion vectors
+     *
+     * Matrices live in two contiguous arrays indexed by a stable handle, swapped every
+     * frame, so looking up the previous transform is a single indexed read.
+     */
+    class TransformHistory
+    {
+    public:
+        RenderObjectHandle allocate();
+        void               release(RenderObjectHandle handle);
+
+        // store this frame's transform and return last frame's (or the same one if it has none / the handle is bad)
+        const glm::mat4& update(RenderObjectHandle handle, const glm::mat4& model_matrix);
+
+        void nextFrame();
+        void clear();
+
+    private:
+        std::array<std::vector<glm::mat4>, 2> m_matrices;
+        std::vector<uint32_t>                 m_last_update; // frame each slot was last written
+        std::vector<bool>                     m_allocated;   // false for released slots
+        std::vector<RenderObjectHandle>       m_free_handles;
+        uint32_t                              m_current {0};
+        uint32_t                              m_frame {1};
+    };
+} // namespace RealmEngine
@@ -21,7 +21,6 @@ namespace RealmEngine
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);                 // use ver 3.x
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);                 // use ver 3.3
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE); // use core profile
-        glfwWindowHint(GLFW_SAMPLES, 4);                               // set MSAA sample nums
 
         // create window
         m_window = glfwCreateWindow(m_width, m_height, m_title.c_str(), nullptr, nullptr);
@@ -44,8 +43,7 @@ namespace RealmEngine
             glfwTerminate();
             return false;
         }
-        glfwSwapInterval(1);      // use v-sync
-        glEnable(GL_MULTISAMPLE); // use MSAA
+        setSwapInterval(1); // use v-sync until FramePacer applies its mode
 
         // bind native window callbacks
         glfwSetWindowUserPointer(m_window, this);
@@ -79,6 +77,15 @@ namespace RealmEngine
         return true;
     }
 
+    void Window::setSwapInterval(int interval)
+    {
+        if (interval == m_swap_interval)
+            return;
+
+        glfwSwapInterval(interval);
+        m_swap_interval = interval;
+    }
+
     void Window::terminate()
     {
         LOG_INFO("Window System terminated");
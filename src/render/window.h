@@ -24,6 +24,10 @@ namespace RealmEngine
         bool shouldClose() { return glfwWindowShouldClose(m_window); }
         void swapBuffers() { glfwSwapBuffers(m_window); }
 
+        // swap interval is window state, not per-pass render state
+        void setSwapInterval(int interval);
+        int  getSwapInterval() const { return m_swap_interval; }
+
         GLFWwindow* getGLFWwindow() const { return m_window; }
         std::string getTitle() const { return m_title; }
         int         getWidth() const { return m_width; }
@@ -224,6 +228,7 @@ namespace RealmEngine
         int         m_framebuffer_width {0};
         int         m_framebuffer_height {0};
         bool        m_visible {false};
+        int         m_swap_interval {-1};
 
         // events
         std::vector<onResetFunc>           m_onResetFunc;
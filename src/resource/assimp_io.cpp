@@ -0,0 +1,66 @@
+#include "assimp_io.h"
+
+#include "global.h"
+
+#include <cstring>
+
+namespace RealmEngine
+{
+    size_t VfsIOStream::Read(void* buffer, size_t size, size_t count)
+    {
+        if (size == 0 || m_position >= m_data.size())
+            return 0;
+
+        // whole elements only, like fread
+        size_t available = (m_data.size() - m_position) / size;
+        size_t read      = count < available ? count : available;
+        std::memcpy(buffer, m_data.data() + m_position, read * size);
+        m_position += read * size;
+        return read;
+    }
+
+    size_t VfsIOStream::Write(const void* /*buffer*/, size_t /*size*/, size_t /*count*/) { return 0; }
+
+    aiReturn VfsIOStream::Seek(size_t offset, aiOrigin origin)
+    {
+        size_t target;
+        switch (origin)
+        {
+            case aiOrigin_SET:
+                target = offset;
+                break;
+            case aiOrigin_CUR:
+                target = m_position + offset;
+                break;
+            case aiOrigin_END:
+                // assimp passes the distance back from the end
+                if (offset > m_data.size())
+                    return aiReturn_FAILURE;
+                target = m_data.size() - offset;
+                break;
+            default:
+                return aiReturn_FAILURE;
+        }
+
+        if (target > m_data.size())
+            return aiReturn_FAILURE;
+
+        m_position = target;
+        return aiReturn_SUCCESS;
+    }
+
+    bool VfsIOSystem::Exists(const char* path) const { return g_context.m_vfs->exists(path); }
+
+    Assimp::IOStream* VfsIOSystem::Open(const char* path, const char* mode)
+    {
+        // the vfs is read-only
+        if (std::strchr(mode, 'w') || std::strchr(mode, 'a'))
+            return nullptr;
+
+        FileData data;
+        if (!g_context.m_vfs->read(path, data))
+            return nullptr;
+
+        return new VfsIOStream(std::move(data));
+    }
+} // namespace RealmEngine
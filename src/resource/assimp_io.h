@@ -0,0 +1,43 @@
+#pragma once
+
+#include "resource/mapped_file.h"
+
+#include <assimp/IOStream.hpp>
+#include <assimp/IOSystem.hpp>
+
+#include <utility>
+
+namespace RealmEngine
+{
+    // read-only assimp stream over a file the VFS already has in memory, seeks are pointer moves
+    class VfsIOStream : public Assimp::IOStream
+    {
+    public:
+        explicit VfsIOStream(FileData data) : m_data(std::move(data)) {}
+
+        size_t   Read(void* buffer, size_t size, size_t count) override;
+        size_t   Write(const void* buffer, size_t size, size_t count) override;
+        aiReturn Seek(size_t offset, aiOrigin origin) override;
+        size_t   Tell() const override { return m_position; }
+        size_t   FileSize() const override { return m_data.size(); }
+        void     Flush() override {}
+
+    private:
+        FileData m_data;
+        size_t   m_position {0};
+    };
+
+    /**
+     * @brief routes every file assimp opens (the model and anything it references, e.g. .mtl) through the VFS
+     *
+     * Hand a new instance to Assimp::Importer::SetIOHandler, the importer owns it from then on.
+     */
+    class VfsIOSystem : public Assimp::IOSystem
+    {
+    public:
+        bool              Exists(const char* path) const override;
+        char              getOsSeparator() const override { return '/'; }
+        Assimp::IOStream* Open(const char* path, const char* mode = "rb") override;
+        void              Close(Assimp::IOStream* stream) override { delete stream; }
+    };
+} // namespace RealmEngine
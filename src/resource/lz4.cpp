@@ -0,0 +1,161 @@
+#include "lz4.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+
+namespace RealmEngine
+{
+    namespace
+    {
+        // block format limits, see lz4_Block_format.md
+        constexpr size_t g_min_match     = 4;
+        constexpr size_t g_last_literals = 5;  // the block always ends in at least this many literals
+        constexpr size_t g_match_limit   = 12; // no match may start closer than this to the end
+        constexpr size_t g_max_offset    = 65535;
+        constexpr int    g_hash_bits     = 16;
+
+        uint32_t read32(const std::byte* p)
+        {
+            uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        uint32_t hashSequence(uint32_t sequence) { return (sequence * 2654435761u) >> (32 - g_hash_bits); }
+
+        // 15 in the token nibble, then 255-runs and a final byte carry the rest
+        void writeLength(std::vector<std::byte>& out, size_t length)
+        {
+            for (; length >= 255; length -= 255)
+                out.push_back(std::byte {255});
+            out.push_back(static_cast<std::byte>(length));
+        }
+
+        void writeSequence(std::vector<std::byte>& out,
+                           const std::byte*        literals,
+                           size_t                  literal_count,
+                           size_t                  offset,
+                           size_t                  match_length)
+        {
+            size_t match_code = match_length > 0 ? match_length - g_min_match : 0;
+            auto   token      = static_cast<uint8_t>((std::min<size_t>(literal_count, 15) << 4) |
+                                              std::min<size_t>(match_code, 15));
+            out.push_back(static_cast<std::byte>(token));
+
+            if (literal_count >= 15)
+                writeLength(out, literal_count - 15);
+            out.insert(out.end(), literals, literals + literal_count);
+
+            // the final sequence is literals only
+            if (match_length == 0)
+                return;
+
+            out.push_back(static_cast<std::byte>(offset & 0xFF));
+            out.push_back(static_cast<std::byte>(offset >> 8));
+            if (match_code >= 15)
+                writeLength(out, match_code - 15);
+        }
+    } // namespace
+
+    std::vector<std::byte> lz4Compress(const std::byte* src, size_t size)
+    {
+        std::vector<std::byte> out;
+        out.reserve(size + size / 255 + 16);
+
+        std::vector<size_t> table(size_t(1) << g_hash_bits, SIZE_MAX);
+
+        size_t anchor = 0;
+        size_t pos    = 0;
+        if (size >= g_match_limit)
+        {
+            const size_t match_end = size - g_last_literals;
+            while (pos + g_match_limit <= size)
+            {
+                uint32_t sequence  = read32(src + pos);
+                uint32_t hash      = hashSequence(sequence);
+                size_t   candidate = table[hash];
+                table[hash]        = pos;
+
+                if (candidate >= pos || pos - candidate > g_max_offset || read32(src + candidate) != sequence)
+                {
+                    ++pos;
+                    continue;
+                }
+
+                size_t length = g_min_match;
+                while (pos + length < match_end && src[candidate + length] == src[pos + length])
+                    ++length;
+
+                writeSequence(out, src + anchor, pos - anchor, pos - candidate, length);
+                pos += length;
+                anchor = pos;
+            }
+        }
+
+        writeSequence(out, src + anchor, size - anchor, 0, 0);
+        return out;
+    }
+
+    bool lz4Decompress(const std::byte* src, size_t src_size, std::byte* dst, size_t dst_size)
+    {
+        size_t in  = 0;
+        size_t out = 0;
+
+        auto readLength = [&](size_t& length) {
+            uint8_t next;
+            do
+            {
+                if (in >= src_size)
+                    return false;
+                next = static_cast<uint8_t>(src[in++]);
+                length += next;
+            } while (next == 255);
+            return true;
+        };
+
+        while (in < src_size)
+        {
+            auto token = static_cast<uint8_t>(src[in++]);
+
+            size_t literal_count = token >> 4;
+            if (literal_count == 15 && !readLength(literal_count))
+                return false;
+            if (literal_count > src_size - in || literal_count > dst_size - out)
+                return false;
+
+            std::memcpy(dst + out, src + in, literal_count);
+            in += literal_count;
+            out += literal_count;
+
+            // the last sequence stops after its literals
+            if (in == src_size)
+                break;
+
+            if (src_size - in < 2)
+                return false;
+            size_t offset = static_cast<size_t>(src[in]) | (static_cast<size_t>(src[in + 1]) << 8);
+            in += 2;
+            if (offset == 0 || offset > out)
+                return false;
+
+            size_t match_length = token & 0x0F;
+            if (match_length == 15 && !readLength(match_length))
+                return false;
+            match_length += g_min_match;
+            if (match_length > dst_size - out)
+                return false;
+
+            // matches may overlap their own output (offset < length repeats a pattern), copy forward
+            const std::byte* match = dst + out - offset;
+            if (offset >= match_length)
+                std::memcpy(dst + out, match, match_length);
+            else
+                for (size_t i = 0; i < match_length; ++i)
+                    dst[out + i] = match[i];
+            out += match_length;
+        }
+
+        return out == dst_size;
+    }
+} // namespace RealmEngine
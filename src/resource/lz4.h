@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace RealmEngine
+{
+    /**
+     * @brief compress into a raw LZ4 block (no frame header), readable by any LZ4 block decoder
+     *
+     * Greedy single-probe matcher, fast enough for packing and far from lz4hc ratios.
+     */
+    std::vector<std::byte> lz4Compress(const std::byte* src, size_t size);
+
+    // decode a raw LZ4 block, false unless it is well formed and decodes to exactly dst_size bytes
+    bool lz4Decompress(const std::byte* src, size_t src_size, std::byte* dst, size_t dst_size);
+} // namespace RealmEngine
@@ -0,0 +1,135 @@
+#include "mapped_file.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace RealmEngine
+{
+    MappedFile::~MappedFile() { close(); }
+
+#ifdef _WIN32
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+
+        HANDLE file = CreateFileA(path.c_str(),
+                                  GENERIC_READ,
+                                  FILE_SHARE_READ,
+                                  nullptr,
+                                  OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                                  nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size))
+        {
+            CloseHandle(file);
+            return false;
+        }
+
+        m_file = file;
+        m_size = static_cast<size_t>(size.QuadPart);
+        m_open = true;
+
+        // empty files cannot be mapped, they are simply open with no data
+        if (m_size == 0)
+            return true;
+
+        m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        void* view = m_mapping ? MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+        if (!view)
+        {
+            close();
+            return false;
+        }
+
+        m_data = static_cast<const std::byte*>(view);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+            UnmapViewOfFile(m_data);
+        if (m_mapping)
+            CloseHandle(m_mapping);
+        if (m_file)
+            CloseHandle(m_file);
+
+        m_data    = nullptr;
+        m_mapping = nullptr;
+        m_file    = nullptr;
+        m_size    = 0;
+        m_open    = false;
+    }
+#else
+    bool MappedFile::open(const std::string& path)
+    {
+        close();
+
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+            return false;
+
+        struct stat info {};
+        if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        m_size = static_cast<size_t>(info.st_size);
+        m_open = true;
+
+        // empty files cannot be mapped, they are simply open with no data
+        if (m_size == 0)
+        {
+            ::close(fd);
+            return true;
+        }
+
+        // the mapping holds its own reference to the file, the descriptor is not needed past this
+        void* view = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED)
+        {
+            m_size = 0;
+            m_open = false;
+            return false;
+        }
+
+        m_data = static_cast<const std::byte*>(view);
+        return true;
+    }
+
+    void MappedFile::close()
+    {
+        if (m_data)
+            munmap(const_cast<std::byte*>(m_data), m_size);
+
+        m_data = nullptr;
+        m_size = 0;
+        m_open = false;
+    }
+#endif
+
+    FileData::FileData(std::shared_ptr<const MappedFile> mapping, size_t offset, size_t size) :
+        m_mapping(std::move(mapping)), m_data(m_mapping->data() + offset), m_size(size)
+    {}
+
+    FileData::FileData(std::vector<std::byte> buffer) :
+        m_buffer(std::move(buffer)), m_data(m_buffer.data()), m_size(m_buffer.size())
+    {}
+} // namespace RealmEngine
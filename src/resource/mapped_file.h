@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace RealmEngine
+{
+    /**
+     * @brief read-only memory mapping of a whole file, unmapped on destruction
+     *
+     * Pages come in on first touch, so opening is one syscall no matter how the file is read afterwards.
+     */
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&)            = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::string& path);
+        void close();
+
+        bool             isOpen() const { return m_open; }
+        const std::byte* data() const { return m_data; }
+        size_t           size() const { return m_size; }
+
+    private:
+        const std::byte* m_data {nullptr};
+        size_t           m_size {0};
+        bool             m_open {false};
+
+#ifdef _WIN32
+        void* m_file {nullptr};
+        void* m_mapping {nullptr};
+#endif
+    };
+
+    // size and write time of a file, write time in std::filesystem::file_time_type ticks
+    struct FileInfo
+    {
+        uint64_t size {0};
+        int64_t  write_time {0};
+    };
+
+    /**
+     * @brief contents of one file, either a view into a mapping it keeps alive or a decompressed buffer it owns
+     */
+    class FileData
+    {
+    public:
+        FileData() = default;
+        FileData(std::shared_ptr<const MappedFile> mapping, size_t offset, size_t size);
+        explicit FileData(std::vector<std::byte> buffer);
+
+        // a copy would point into the other one's buffer
+        FileData(const FileData&)            = delete;
+        FileData& operator=(const FileData&) = delete;
+        FileData(FileData&&)                 = default;
+        FileData& operator=(FileData&&)      = default;
+
+        const std::byte* data() const { return m_data; }
+        size_t           size() const { return m_size; }
+        bool             empty() const { return m_size == 0; }
+        std::string_view view() const { return {reinterpret_cast<const char*>(m_data), m_size}; }
+
+    private:
+        std::shared_ptr<const MappedFile> m_mapping;
+        std::vector<std::byte>            m_buffer;
+        const std::byte*                  m_data {nullptr};
+        size_t                            m_size {0};
+    };
+} // namespace RealmEngine
@@ -0,0 +1,301 @@
+#include "mesh_cache.h"
+
+#include "global.h"
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+
+namespace RealmEngine
+{
+    namespace
+    {
+        struct CookedHeader
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t vertex_size;
+            uint32_t mesh_count;
+            uint64_t source_size;
+            int64_t  source_time;
+        };
+
+        bool querySource(const std::string& source_path, uint64_t& size, int64_t& time)
+        {
+            FileInfo info;
+            if (!g_context.m_vfs->stat(source_path, info))
+                return false;
+
+            size = info.size;
+            time = info.write_time;
+            return true;
+        }
+
+        // bounds-checked sequential reads out of a mapped file, sticky failure like an istream
+        class CookedReader
+        {
+        public:
+            explicit CookedReader(const FileData& data) : m_data(data) {}
+
+            void read(void* dst, size_t bytes)
+            {
+                if (m_failed || bytes > remaining())
+                {
+                    m_failed = true;
+                    return;
+                }
+                if (bytes > 0)
+                    std::memcpy(dst, m_data.data() + m_offset, bytes);
+                m_offset += bytes;
+            }
+
+            size_t remaining() const { return m_data.size() - m_offset; }
+            void   fail() { m_failed = true; }
+            explicit operator bool() const { return !m_failed; }
+
+        private:
+            const FileData& m_data;
+            size_t          m_offset {0};
+            bool            m_failed {false};
+        };
+    } // namespace
+
+    std::string MeshCache::getCookedPath(const std::string& source_path) { return source_path + ".cooked"; }
+
+    bool MeshCache::load(const std::string& source_path, std::vector<CookedMesh>& meshes)
+    {
+        meshes.clear();
+
+        uint64_t source_size = 0;
+        int64_t  source_time = 0;
+        if (!querySource(source_path, source_size, source_time))
+            return false;
+
+        // cooked files may themselves live in an archive next to their source
+        FileData data;
+        if (!g_context.m_vfs->read(getCookedPath(source_path), data))
+            return false;
+
+        CookedReader file(data);
+        CookedHeader header {};
+        file.read(&header, sizeof(header));
+        if (!file || header.magic != m_MAGIC || header.version != m_VERSION || header.vertex_size != sizeof(Vertex) ||
+            header.source_size != source_size || header.source_time != source_time)
+            return false;
+
+        // counts are checked against the file size before anything is allocated for them
+        if (header.mesh_count > file.remaining() / sizeof(uint32_t))
+            file.fail();
+
+        meshes.resize(file ? header.mesh_count : 0);
+        for (CookedMesh& mesh : meshes)
+        {
+            uint32_t part_count = 0;
+            file.read(&part_count, sizeof(part_count));
+            if (part_count > file.remaining() / (4 * sizeof(uint32_t)))
+                file.fail();
+            if (!file)
+                break;
+
+            mesh.parts.resize(part_count);
+            for (CookedGeometry& part : mesh.parts)
+            {
+                // vertices, indices, lods, meshlets
+                uint32_t counts[4] {0, 0, 0, 0};
+                file.read(counts, sizeof(counts));
+                uint64_t bytes = uint64_t(counts[0]) * sizeof(Vertex) + uint64_t(counts[1]) * sizeof(unsigned int) +
+                                 uint64_t(counts[2]) * sizeof(MeshLod) + uint64_t(counts[3]) * sizeof(Meshlet);
+                if (bytes > file.remaining())
+                    file.fail();
+                if (!file)
+                    break;
+
+                part.vertices.resize(counts[0]);
+                part.indices.resize(counts[1]);
+                part.lods.resize(counts[2]);
+                part.meshlets.resize(counts[3]);
+                file.read(part.vertices.data(), counts[0] * sizeof(Vertex));
+                file.read(part.indices.data(), counts[1] * sizeof(unsigned int));
+                file.read(part.lods.data(), counts[2] * sizeof(MeshLod));
+                file.read(part.meshlets.data(), counts[3] * sizeof(Meshlet));
+
+                // ranges and indices go to the gpu as they are, written so a crafted value cannot wrap past them
+                for (const MeshLod& lod : part.lods)
+                {
+                    if (lod.index_offset > counts[1] || lod.index_count > counts[1] - lod.index_offset)
+                        file.fail();
+                }
+                for (const Meshlet& meshlet : part.meshlets)
+                {
+                    if (meshlet.index_offset > counts[1] || meshlet.index_count > counts[1] - meshlet.index_offset)
+                        file.fail();
+                }
+                for (unsigned int index : part.indices)
+                {
+                    if (index >= counts[0])
+                    {
+                        file.fail();
+                        break;
+                    }
+                }
+            }
+        }
+
+        if (!file)
+        {
+            LOG_WARN("Cooked mesh file " + getCookedPath(source_path) + " is truncated or corrupt, recooking");
+            meshes.clear();
+            return false;
+        }
+        return true;
+    }
+
+    bool MeshCache::store(const std::string& source_path, const std::vector<CookedMesh>& meshes)
+    {
+        CookedHeader header {};
+        header.magic       = m_MAGIC;
+        header.version     = m_VERSION;
+        header.vertex_size = sizeof(Vertex);
+        header.mesh_count  = static_cast<uint32_t>(meshes.size());
+        if (!querySource(source_path, header.source_size, header.source_time))
+            return false;
+
+        // sources that only exist inside an archive cannot get a cache written next to them
+        std::string cooked_path = g_context.m_vfs->resolveWritePath(getCookedPath(source_path));
+        if (cooked_path.empty())
+            return false;
+
+        // write to a temporary and rename, a crash mid-write must not leave a valid-looking header
+        std::string temp_path   = cooked_path + ".tmp";
+        {
+            std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+            if (!file)
+            {
+                LOG_WARN("Could not write cooked mesh file " + cooked_path);
+                return false;
+            }
+
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            for (const CookedMesh& mesh : meshes)
+            {
+                auto part_count = static_cast<uint32_t>(mesh.parts.size());
+                file.write(reinterpret_cast<const char*>(&part_count), sizeof(part_count));
+
+                for (const CookedGeometry& part : mesh.parts)
+                {
+                    uint32_t counts[4] {static_cast<uint32_t>(part.vertices.size()),
+                                        static_cast<uint32_t>(part.indices.size()),
+                                        static_cast<uint32_t>(part.lods.size()),
+                                        static_cast<uint32_t>(part.meshlets.size())};
+                    file.write(reinterpret_cast<const char*>(counts), sizeof(counts));
+                    file.write(reinterpret_cast<const char*>(part.vertices.data()),
+                               part.vertices.size() * sizeof(Vertex));
+                    file.write(reinterpret_cast<const char*>(part.indices.data()),
+                               part.indices.size() * sizeof(unsigned int));
+                    file.write(reinterpret_cast<const char*>(part.lods.data()), part.lods.size() * sizeof(MeshLod));
+                    file.write(reinterpret_cast<const char*>(part.meshlets.data()),
+                               part.meshlets.size() * sizeof(Meshlet));
+                }
+            }
+
+            if (!file)
+            {
+                LOG_WARN("Could not write cooked mesh file " + cooked_path);
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        std::filesystem::rename(temp_path, cooked_path, ec);
+        if (ec)
+        {
+            LOG_WARN("Could not write cooked mesh file " + cooked_path + ": " + ec.message());
+            std::filesystem::remove(temp_path, ec);
+            return false;
+        }
+        return true;
+    }
+
+    bool MeshCache::checkCorruptFiles(const std::string& directory)
+    {
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+
+        std::string source_path = directory + "/check.obj";
+        {
+            std::ofstream source(source_path, std::ios::binary | std::ios::trunc);
+            source << "o check\n";
+        }
+
+        // one triangle with a single lod and meshlet
+        CookedGeometry part;
+        part.vertices.resize(3);
+        part.indices  = {0, 1, 2};
+        part.lods     = {{0, 3, 0.0f}};
+        part.meshlets = {{glm::vec3(0.0f), 1.0f, glm::vec3(0.0f, 0.0f, 1.0f), 1.0f, 0, 3}};
+        std::vector<CookedMesh> meshes(1);
+        meshes[0].parts.push_back(part);
+
+        FileData                loaded;
+        std::vector<CookedMesh> result;
+        if (!store(source_path, meshes) || !g_context.m_vfs->read(getCookedPath(source_path), loaded) ||
+            !load(source_path, result))
+        {
+            LOG_ERROR("MeshCache check could not round-trip a cooked file in " + directory);
+            return false;
+        }
+        const char*       loaded_bytes = reinterpret_cast<const char*>(loaded.data());
+        std::vector<char> valid(loaded_bytes, loaded_bytes + loaded.size());
+
+        // file layout: header, part count, counts[4], vertices, indices, lods, meshlets
+        size_t indices_at  = sizeof(CookedHeader) + sizeof(uint32_t) + 4 * sizeof(uint32_t) + 3 * sizeof(Vertex);
+        size_t lod_at      = indices_at + 3 * sizeof(unsigned int);
+        size_t meshlet_at  = lod_at + sizeof(MeshLod);
+        auto   patch_value = [](std::vector<char>& bytes, size_t offset, uint32_t value) {
+            std::memcpy(bytes.data() + offset, &value, sizeof(value));
+        };
+
+        struct Case
+        {
+            const char*       name;
+            std::vector<char> bytes;
+        };
+        std::vector<Case> cases;
+
+        cases.push_back({"truncated", valid});
+        cases.back().bytes.pop_back();
+
+        // offset + count wraps around to 3
+        cases.push_back({"wrapped lod range", valid});
+        patch_value(cases.back().bytes, lod_at + offsetof(MeshLod, index_offset), 0xFFFFFFFF);
+        patch_value(cases.back().bytes, lod_at + offsetof(MeshLod, index_count), 4);
+
+        cases.push_back({"wrapped meshlet range", valid});
+        patch_value(cases.back().bytes, meshlet_at + offsetof(Meshlet, index_offset), 0xFFFFFFFF);
+        patch_value(cases.back().bytes, meshlet_at + offsetof(Meshlet, index_count), 4);
+
+        cases.push_back({"index past the vertices", valid});
+        patch_value(cases.back().bytes, indices_at, 3);
+
+        bool passed = true;
+        for (const Case& test : cases)
+        {
+            {
+                std::ofstream file(getCookedPath(source_path), std::ios::binary | std::ios::trunc);
+                file.write(test.bytes.data(), static_cast<std::streamsize>(test.bytes.size()));
+            }
+            if (load(source_path, result) || !result.empty())
+            {
+                LOG_ERROR(std::string("MeshCache accepted a corrupt cooked file: ") + test.name);
+                passed = false;
+            }
+        }
+
+        std::filesystem::remove(getCookedPath(source_path), ec);
+        std::filesystem::remove(source_path, ec);
+        LOG_INFO(std::string("MeshCache check ") + (passed ? "passed" : "failed"));
+        return passed;
+    }
+} // namespace RealmEngine
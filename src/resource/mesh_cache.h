@@ -0,0 +1,48 @@
+#pragma once
+
+#include "resource/model.h"
+
+#include <string>
+#include <vector>
+
+namespace RealmEngine
+{
+    // one drawable Mesh, already deduplicated and optimized, indices hold every lod back to back
+    struct CookedGeometry
+    {
+        std::vector<Vertex>       vertices;
+        std::vector<unsigned int> indices;
+        std::vector<MeshLod>      lods;
+        std::vector<Meshlet>      meshlets;
+    };
+
+    // import-ready geometry of one aiMesh, more than one part when it does not fit 16-bit indices
+    struct CookedMesh
+    {
+        std::vector<CookedGeometry> parts;
+    };
+
+    /**
+     * @brief on-disk cache of optimized model geometry, stored next to the source as <path>.cooked
+     *
+     * Entries are indexed like aiScene::mMeshes and are only valid for the exact source file
+     * (size and write time) and cooker version they were written with.
+     */
+    class MeshCache
+    {
+    public:
+        static std::string getCookedPath(const std::string& source_path);
+
+        // false if there is no cooked file or it is stale, meshes is left empty then
+        static bool load(const std::string& source_path, std::vector<CookedMesh>& meshes);
+        static bool store(const std::string& source_path, const std::vector<CookedMesh>& meshes);
+
+        // writes truncated and out-of-range cooked files into directory, true if load() rejects every one
+        static bool checkCorruptFiles(const std::string& directory);
+
+    private:
+        // bump whenever Vertex or the optimizer output changes
+        static constexpr uint32_t m_VERSION = 3;
+        static constexpr uint32_t m_MAGIC   = 0x4B4F4F43; // "COOK"
+    };
+} // namespace RealmEngine
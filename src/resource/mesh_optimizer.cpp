@@ -0,0 +1,754 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace RealmEngine
+{
+    namespace
+    {
+        constexpr uint32_t g_no_vertex = UINT32_MAX;
+
+        // below this a coarser level saves too little to be worth another range in the index buffer
+        constexpr size_t g_min_lod_triangles = 64;
+
+        // vertex -> triangles using it, live = triangles not yet emitted
+        struct Adjacency
+        {
+            std::vector<uint32_t> offsets;
+            std::vector<uint32_t> triangles;
+            std::vector<uint32_t> live;
+        };
+
+        Adjacency buildAdjacency(const std::vector<unsigned int>& indices, size_t vertex_count)
+        {
+            Adjacency adjacency;
+            adjacency.live.assign(vertex_count, 0);
+            adjacency.offsets.assign(vertex_count + 1, 0);
+            adjacency.triangles.resize(indices.size());
+
+            for (unsigned int index : indices)
+                ++adjacency.live[index];
+
+            for (size_t v = 0; v < vertex_count; ++v)
+                adjacency.offsets[v + 1] = adjacency.offsets[v] + adjacency.live[v];
+
+            std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+            for (size_t i = 0; i < indices.size(); ++i)
+                adjacency.triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+
+            return adjacency;
+        }
+
+        /**
+         * @brief Tipsify (Sander et al. 2007), fans around the vertex that stays in cache the longest
+         *
+         * cluster_starts receives the first triangle of every run that begins with a cold cache,
+         * those are the points where reordering for overdraw does not cost extra cache misses.
+         */
+        std::vector<unsigned int> tipsify(const std::vector<unsigned int>& indices,
+                                          size_t                           vertex_count,
+                                          size_t                           cache_size,
+                                          std::vector<uint32_t>&           cluster_starts)
+        {
+            Adjacency              adjacency = buildAdjacency(indices, vertex_count);
+            std::vector<uint32_t>& live      = adjacency.live;
+
+            std::vector<uint32_t>     cache_time(vertex_count, 0);
+            std::vector<bool>         emitted(indices.size() / 3, false);
+            std::vector<uint32_t>     dead_end;
+            std::vector<uint32_t>     candidates;
+            std::vector<unsigned int> result;
+            dead_end.reserve(indices.size());
+            result.reserve(indices.size());
+
+            auto   timestamp = static_cast<uint32_t>(cache_size + 1);
+            size_t cursor    = 0;
+
+            auto next_from_cursor = [&]() -> uint32_t {
+                for (; cursor < vertex_count; ++cursor)
+                {
+                    if (live[cursor] > 0)
+                        return static_cast<uint32_t>(cursor);
+                }
+                return g_no_vertex;
+            };
+
+            uint32_t fan = next_from_cursor();
+            while (fan != g_no_vertex)
+            {
+                if (timestamp - cache_time[fan] > cache_size)
+                    cluster_starts.push_back(static_cast<uint32_t>(result.size() / 3));
+
+                candidates.clear();
+                for (uint32_t k = adjacency.offsets[fan]; k < adjacency.offsets[fan + 1]; ++k)
+                {
+                    uint32_t triangle = adjacency.triangles[k];
+                    if (emitted[triangle])
+                        continue;
+                    emitted[triangle] = true;
+
+                    for (uint32_t c = 0; c < 3; ++c)
+                    {
+                        uint32_t v = indices[triangle * 3 + c];
+                        result.push_back(v);
+                        dead_end.push_back(v);
+                        candidates.push_back(v);
+                        --live[v];
+                        if (timestamp - cache_time[v] > cache_size)
+                            cache_time[v] = timestamp++;
+                    }
+                }
+
+                // among the fan's vertices, take the oldest one that will still be cached after its remaining triangles
+                uint32_t best          = g_no_vertex;
+                int64_t  best_priority = -1;
+                for (uint32_t v : candidates)
+                {
+                    if (live[v] == 0)
+                        continue;
+
+                    int64_t  priority = 0;
+                    uint32_t age      = timestamp - cache_time[v];
+                    if (age + 2 * live[v] <= cache_size)
+                        priority = age;
+
+                    if (priority > best_priority)
+                    {
+                        best          = v;
+                        best_priority = priority;
+                    }
+                }
+
+                // dead end, go back to a recently touched vertex before scanning forward
+                while (best == g_no_vertex && !dead_end.empty())
+                {
+                    uint32_t v = dead_end.back();
+                    dead_end.pop_back();
+                    if (live[v] > 0)
+                        best = v;
+                }
+                if (best == g_no_vertex)
+                    best = next_from_cursor();
+
+                fan = best;
+            }
+
+            return result;
+        }
+
+        /**
+         * @brief sort clusters so the ones facing out of the mesh draw first, they tend to occlude the rest
+         */
+        void sortClustersForOverdraw(std::vector<unsigned int>&   indices,
+                                     const std::vector<Vertex>&   vertices,
+                                     const std::vector<uint32_t>& cluster_starts)
+        {
+            struct Cluster
+            {
+                uint32_t  begin;
+                uint32_t  end;
+                glm::vec3 centroid;
+                glm::vec3 normal;
+                float     sort_key;
+            };
+
+            const auto triangle_count = static_cast<uint32_t>(indices.size() / 3);
+
+            std::vector<Cluster> clusters;
+            clusters.reserve(cluster_starts.size());
+
+            glm::vec3 mesh_centroid(0.0f);
+            float     mesh_area = 0.0f;
+            for (size_t c = 0; c < cluster_starts.size(); ++c)
+            {
+                Cluster cluster {};
+                cluster.begin = cluster_starts[c];
+                cluster.end   = c + 1 < cluster_starts.size() ? cluster_starts[c + 1] : triangle_count;
+
+                float area = 0.0f;
+                for (uint32_t t = cluster.begin; t < cluster.end; ++t)
+                {
+                    const glm::vec3& p0 = vertices[indices[t * 3 + 0]].position;
+                    const glm::vec3& p1 = vertices[indices[t * 3 + 1]].position;
+                    const glm::vec3& p2 = vertices[indices[t * 3 + 2]].position;
+
+                    glm::vec3 cross         = glm::cross(p1 - p0, p2 - p0);
+                    float     triangle_area = glm::length(cross);
+
+                    cluster.normal += cross; // area weighted
+                    cluster.centroid += (p0 + p1 + p2) * (triangle_area / 3.0f);
+                    area += triangle_area;
+                }
+
+                mesh_centroid += cluster.centroid;
+                mesh_area += area;
+                if (area > 0.0f)
+                    cluster.centroid /= area;
+
+                clusters.push_back(cluster);
+            }
+
+            if (mesh_area > 0.0f)
+                mesh_centroid /= mesh_area;
+
+            for (Cluster& cluster : clusters)
+            {
+                float length     = glm::length(cluster.normal);
+                cluster.sort_key = length > 0.0f ? glm::dot(cluster.centroid - mesh_centroid, cluster.normal / length)
+                                                 : 0.0f;
+            }
+
+            std::stable_sort(clusters.begin(), clusters.end(), [](const Cluster& a, const Cluster& b) {
+                return a.sort_key > b.sort_key;
+            });
+
+            std::vector<unsigned int> sorted;
+            sorted.reserve(indices.size());
+            for (const Cluster& cluster : clusters)
+            {
+                sorted.insert(sorted.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+            }
+            indices.swap(sorted);
+        }
+
+        // renumber vertices in first-use order so fetches walk the vertex buffer linearly, drops unused vertices
+        void remapVertexFetch(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+        {
+            std::vector<uint32_t> remap(vertices.size(), g_no_vertex);
+            std::vector<Vertex>   reordered;
+            reordered.reserve(vertices.size());
+
+            for (unsigned int& index : indices)
+            {
+                if (remap[index] == g_no_vertex)
+                {
+                    remap[index] = static_cast<uint32_t>(reordered.size());
+                    reordered.push_back(vertices[index]);
+                }
+                index = remap[index];
+            }
+
+            vertices.swap(reordered);
+        }
+
+        // triangle order only, for index lists that share a vertex buffer with other lists
+        void optimizeTriangleOrder(std::vector<unsigned int>& indices, const std::vector<Vertex>& vertices)
+        {
+            std::vector<uint32_t> cluster_starts;
+            indices = tipsify(indices, vertices.size(), g_vertex_cache_size, cluster_starts);
+            sortClustersForOverdraw(indices, vertices, cluster_starts);
+        }
+
+        // sum of squared plane distances (Garland & Heckbert 1997), divided by weight it stays in distance units
+        struct Quadric
+        {
+            double a2 {0.0}, b2 {0.0}, c2 {0.0}, d2 {0.0};
+            double ab {0.0}, ac {0.0}, ad {0.0}, bc {0.0}, bd {0.0}, cd {0.0};
+            double weight {0.0};
+
+            void addPlane(const glm::vec3& n, float d, float w)
+            {
+                a2 += w * n.x * n.x;
+                b2 += w * n.y * n.y;
+                c2 += w * n.z * n.z;
+                d2 += w * d * d;
+                ab += w * n.x * n.y;
+                ac += w * n.x * n.z;
+                ad += w * n.x * d;
+                bc += w * n.y * n.z;
+                bd += w * n.y * d;
+                cd += w * n.z * d;
+                weight += w;
+            }
+
+            Quadric& operator+=(const Quadric& other)
+            {
+                a2 += other.a2;
+                b2 += other.b2;
+                c2 += other.c2;
+                d2 += other.d2;
+                ab += other.ab;
+                ac += other.ac;
+                ad += other.ad;
+                bc += other.bc;
+                bd += other.bd;
+                cd += other.cd;
+                weight += other.weight;
+                return *this;
+            }
+
+            // weighted mean squared distance of p to the accumulated planes
+            double evaluate(const glm::vec3& p) const
+            {
+                if (weight <= 0.0)
+                    return 0.0;
+
+                double x = p.x, y = p.y, z = p.z;
+                double e = a2 * x * x + b2 * y * y + c2 * z * z + d2 +
+                           2.0 * (ab * x * y + ac * x * z + ad * x + bc * y * z + bd * y + cd * z);
+                return std::max(e, 0.0) / weight;
+            }
+        };
+
+        std::vector<Quadric> computeQuadrics(const std::vector<Vertex>&       vertices,
+                                             const std::vector<unsigned int>& indices)
+        {
+            std::vector<Quadric> quadrics(vertices.size());
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                const glm::vec3& p0 = vertices[indices[i + 0]].position;
+                const glm::vec3& p1 = vertices[indices[i + 1]].position;
+                const glm::vec3& p2 = vertices[indices[i + 2]].position;
+
+                glm::vec3 cross  = glm::cross(p1 - p0, p2 - p0);
+                float     length = glm::length(cross);
+                if (length <= 0.0f)
+                    continue;
+
+                glm::vec3 normal = cross / length;
+                float     d      = -glm::dot(normal, p0);
+                for (size_t c = 0; c < 3; ++c)
+                    quadrics[indices[i + c]].addPlane(normal, d, length * 0.5f); // area weighted
+            }
+            return quadrics;
+        }
+
+        /**
+         * @brief vertices that must not move: open borders and attribute seams (several vertices on one position)
+         */
+        std::vector<bool> findLockedVertices(const std::vector<Vertex>&       vertices,
+                                             const std::vector<unsigned int>& indices)
+        {
+            // group vertices by exact position
+            std::vector<uint32_t> order(vertices.size());
+            std::iota(order.begin(), order.end(), 0u);
+            auto less = [&](uint32_t a, uint32_t b) {
+                const glm::vec3& pa = vertices[a].position;
+                const glm::vec3& pb = vertices[b].position;
+                if (pa.x != pb.x)
+                    return pa.x < pb.x;
+                if (pa.y != pb.y)
+                    return pa.y < pb.y;
+                return pa.z < pb.z;
+            };
+            std::sort(order.begin(), order.end(), less);
+
+            std::vector<bool>     locked(vertices.size(), false);
+            std::vector<uint32_t> position_id(vertices.size(), 0);
+            for (size_t i = 0; i < order.size();)
+            {
+                size_t j = i + 1;
+                while (j < order.size() && !less(order[i], order[j]))
+                    ++j;
+
+                for (size_t k = i; k < j; ++k)
+                {
+                    position_id[order[k]] = order[i];
+                    if (j - i > 1)
+                        locked[order[k]] = true;
+                }
+                i = j;
+            }
+
+            // a directed edge without its twin lies on an open border
+            std::vector<uint64_t> edges;
+            edges.reserve(indices.size());
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    uint64_t a = position_id[indices[i + c]];
+                    uint64_t b = position_id[indices[i + (c + 1) % 3]];
+                    edges.push_back((a << 32) | b);
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+
+            for (size_t i = 0; i + 2 < indices.size(); i += 3)
+            {
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    uint64_t a = position_id[indices[i + c]];
+                    uint64_t b = position_id[indices[i + (c + 1) % 3]];
+                    if (!std::binary_search(edges.begin(), edges.end(), (b << 32) | a))
+                    {
+                        locked[indices[i + c]]             = true;
+                        locked[indices[i + (c + 1) % 3]] = true;
+                    }
+                }
+            }
+
+            return locked;
+        }
+
+        // true if moving `from` onto `to` turns any remaining triangle around `from` upside down
+        bool collapseFlips(uint32_t                         from,
+                           uint32_t                         to,
+                           const std::vector<unsigned int>& indices,
+                           const Adjacency&                 adjacency,
+                           const std::vector<Vertex>&       vertices)
+        {
+            for (uint32_t k = adjacency.offsets[from]; k < adjacency.offsets[from + 1]; ++k)
+            {
+                const unsigned int* tri = &indices[adjacency.triangles[k] * 3];
+                if (tri[0] == to || tri[1] == to || tri[2] == to)
+                    continue; // becomes degenerate and is removed
+
+                glm::vec3 p[3];
+                glm::vec3 q[3];
+                for (size_t c = 0; c < 3; ++c)
+                {
+                    p[c] = vertices[tri[c]].position;
+                    q[c] = tri[c] == from ? vertices[to].position : p[c];
+                }
+
+                glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+                glm::vec3 after  = glm::cross(q[1] - q[0], q[2] - q[0]);
+                if (glm::dot(before, after) <= 0.0f)
+                    return true;
+            }
+            return false;
+        }
+
+        /**
+         * @brief collapse edges onto existing vertices until indices is at most target_index_count
+         *
+         * Runs in passes over the cheapest collapses, a vertex takes part in at most one per pass so
+         * flip checks stay valid. Stops early when nothing can collapse. Returns the largest
+         * collapse error, as a distance in mesh units.
+         */
+        float simplify(std::vector<unsigned int>& indices,
+                       const std::vector<Vertex>& vertices,
+                       const std::vector<bool>&   locked,
+                       std::vector<Quadric>&      quadrics,
+                       size_t                     target_index_count)
+        {
+            struct Collapse
+            {
+                uint32_t from;
+                uint32_t to;
+                double   error;
+            };
+
+            std::vector<Collapse> collapses;
+            std::vector<bool>     frozen(vertices.size());
+            std::vector<uint32_t> remap(vertices.size());
+            double                max_error = 0.0;
+
+            while (indices.size() > target_index_count)
+            {
+                collapses.clear();
+                for (size_t i = 0; i + 2 < indices.size(); i += 3)
+                {
+                    for (size_t c = 0; c < 3; ++c)
+                    {
+                        uint32_t a = indices[i + c];
+                        uint32_t b = indices[i + (c + 1) % 3];
+                        for (auto [from, to] : {std::pair {a, b}, std::pair {b, a}})
+                        {
+                            if (from == to || locked[from])
+                                continue;
+
+                            Quadric q = quadrics[from];
+                            q += quadrics[to];
+                            collapses.push_back({from, to, q.evaluate(vertices[to].position)});
+                        }
+                    }
+                }
+                if (collapses.empty())
+                    break;
+
+                std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) {
+                    return a.error < b.error;
+                });
+
+                Adjacency adjacency = buildAdjacency(indices, vertices.size());
+                std::fill(frozen.begin(), frozen.end(), false);
+                std::iota(remap.begin(), remap.end(), 0u);
+
+                // a collapse removes about two triangles
+                size_t goal      = (indices.size() - target_index_count) / 6 + 1;
+                size_t performed = 0;
+                for (const Collapse& collapse : collapses)
+                {
+                    if (performed >= goal)
+                        break;
+                    if (frozen[collapse.from] || frozen[collapse.to])
+                        continue;
+                    if (collapseFlips(collapse.from, collapse.to, indices, adjacency, vertices))
+                        continue;
+
+                    remap[collapse.from] = collapse.to;
+                    quadrics[collapse.to] += quadrics[collapse.from];
+
+                    for (uint32_t k = adjacency.offsets[collapse.from]; k < adjacency.offsets[collapse.from + 1]; ++k)
+                    {
+                        for (size_t c = 0; c < 3; ++c)
+                            frozen[indices[adjacency.triangles[k] * 3 + c]] = true;
+                    }
+
+                    max_error = std::max(max_error, collapse.error);
+                    ++performed;
+                }
+                if (performed == 0)
+                    break;
+
+                size_t write = 0;
+                for (size_t i = 0; i + 2 < indices.size(); i += 3)
+                {
+                    uint32_t a = remap[indices[i + 0]];
+                    uint32_t b = remap[indices[i + 1]];
+                    uint32_t c = remap[indices[i + 2]];
+                    if (a == b || b == c || a == c)
+                        continue;
+
+                    indices[write++] = a;
+                    indices[write++] = b;
+                    indices[write++] = c;
+                }
+                indices.resize(write);
+            }
+
+            return static_cast<float>(std::sqrt(max_error));
+        }
+    } // namespace
+
+    float computeACMR(const std::vector<unsigned int>& indices, size_t vertex_count, size_t cache_size)
+    {
+        if (indices.size() < 3)
+            return 0.0f;
+
+        // fifo: a vertex is cached while fewer than cache_size misses happened since it was loaded
+        std::vector<uint32_t> cache_time(vertex_count, 0);
+        auto                  timestamp = static_cast<uint32_t>(cache_size + 1);
+        size_t                misses    = 0;
+
+        for (unsigned int index : indices)
+        {
+            if (timestamp - cache_time[index] > cache_size)
+            {
+                cache_time[index] = timestamp++;
+                ++misses;
+            }
+        }
+
+        return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+    }
+
+    MeshOptimizeStats optimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices)
+    {
+        MeshOptimizeStats stats;
+        stats.vertices_before = vertices.size();
+        stats.vertices_after  = vertices.size();
+
+        // only plain triangle lists, anything with leftover points or lines is left alone
+        if (indices.size() < 3 || indices.size() % 3 != 0)
+            return stats;
+
+        stats.acmr_before = computeACMR(indices, vertices.size());
+
+        optimizeTriangleOrder(indices, vertices);
+        remapVertexFetch(vertices, indices);
+
+        stats.vertices_after = vertices.size();
+        stats.acmr_after     = computeACMR(indices, vertices.size());
+        return stats;
+    }
+
+    std::vector<CookedGeometry> splitMesh(const CookedGeometry& mesh, size_t max_vertices)
+    {
+        std::vector<CookedGeometry> parts;
+        CookedGeometry              part;
+        std::vector<uint32_t>       remap(mesh.vertices.size(), g_no_vertex);
+        std::vector<uint32_t>       used; // entries of remap set for the current part
+
+        for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3)
+        {
+            size_t new_vertices = 0;
+            for (size_t c = 0; c < 3; ++c)
+            {
+                if (remap[mesh.indices[t + c]] == g_no_vertex)
+                    ++new_vertices;
+            }
+
+            if (part.vertices.size() + new_vertices > max_vertices)
+            {
+                parts.push_back(std::move(part));
+                part = {};
+                for (uint32_t v : used)
+                    remap[v] = g_no_vertex;
+                used.clear();
+            }
+
+            for (size_t c = 0; c < 3; ++c)
+            {
+                uint32_t v = mesh.indices[t + c];
+                if (remap[v] == g_no_vertex)
+                {
+                    remap[v] = static_cast<uint32_t>(part.vertices.size());
+                    part.vertices.push_back(mesh.vertices[v]);
+                    used.push_back(v);
+                }
+                part.indices.push_back(remap[v]);
+            }
+        }
+
+        if (!part.indices.empty())
+            parts.push_back(std::move(part));
+
+        return parts;
+    }
+
+    void buildMeshlets(CookedGeometry& geometry)
+    {
+        geometry.meshlets.clear();
+
+        const std::vector<unsigned int>& indices = geometry.indices;
+        if (indices.size() % 3 != 0 || indices.size() / 3 < g_meshlet_min_mesh_triangles)
+            return;
+
+        auto finish = [&](uint32_t begin, uint32_t end) {
+            Meshlet meshlet {};
+            meshlet.index_offset = begin;
+            meshlet.index_count  = end - begin;
+
+            // bounding sphere around the aabb center, good enough at this size
+            glm::vec3 lo = geometry.vertices[indices[begin]].position;
+            glm::vec3 hi = lo;
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                lo = glm::min(lo, geometry.vertices[indices[i]].position);
+                hi = glm::max(hi, geometry.vertices[indices[i]].position);
+            }
+            meshlet.center = (lo + hi) * 0.5f;
+            for (uint32_t i = begin; i < end; ++i)
+            {
+                meshlet.radius =
+                    std::max(meshlet.radius, glm::length(geometry.vertices[indices[i]].position - meshlet.center));
+            }
+
+            // normal cone, cutoff = sin(half-angle) so the runtime test needs no trig
+            glm::vec3 normals[g_meshlet_max_triangles];
+            size_t    normal_count = 0;
+            glm::vec3 axis(0.0f);
+            for (uint32_t i = begin; i < end; i += 3)
+            {
+                const glm::vec3& p0 = geometry.vertices[indices[i + 0]].position;
+                const glm::vec3& p1 = geometry.vertices[indices[i + 1]].position;
+                const glm::vec3& p2 = geometry.vertices[indices[i + 2]].position;
+
+                glm::vec3 cross  = glm::cross(p1 - p0, p2 - p0);
+                float     length = glm::length(cross);
+                if (length <= 0.0f)
+                    continue;
+
+                normals[normal_count++] = cross / length;
+                axis += cross / length;
+            }
+
+            meshlet.cone_axis   = glm::vec3(0.0f, 0.0f, 1.0f);
+            meshlet.cone_cutoff = 1.0f;
+
+            float axis_length = glm::length(axis);
+            if (axis_length > 0.0f)
+            {
+                meshlet.cone_axis = axis / axis_length;
+
+                float min_dot = 1.0f;
+                for (size_t n = 0; n < normal_count; ++n)
+                    min_dot = std::min(min_dot, glm::dot(meshlet.cone_axis, normals[n]));
+
+                // a cone wider than a hemisphere always has a triangle facing the camera
+                if (min_dot > 0.0f)
+                    meshlet.cone_cutoff = std::sqrt(1.0f - min_dot * min_dot);
+            }
+
+            geometry.meshlets.push_back(meshlet);
+        };
+
+        // last meshlet each vertex was added to
+        std::vector<uint32_t> owner(geometry.vertices.size(), g_no_vertex);
+        uint32_t              meshlet_id     = 0;
+        uint32_t              begin          = 0;
+        size_t                vertex_count   = 0;
+        size_t                triangle_count = 0;
+
+        for (uint32_t i = 0; i < indices.size(); i += 3)
+        {
+            uint32_t a = indices[i + 0];
+            uint32_t b = indices[i + 1];
+            uint32_t c = indices[i + 2];
+
+            size_t new_vertices = 0;
+            new_vertices += owner[a] != meshlet_id ? 1 : 0;
+            new_vertices += owner[b] != meshlet_id && b != a ? 1 : 0;
+            new_vertices += owner[c] != meshlet_id && c != a && c != b ? 1 : 0;
+
+            // full, or the triangle order jumped away and the meshlet is already reasonably sized
+            bool full         = triangle_count == g_meshlet_max_triangles ||
+                                vertex_count + new_vertices > g_meshlet_max_vertices;
+            bool disconnected = new_vertices == 3 && triangle_count >= g_meshlet_max_triangles / 4;
+            if (triangle_count > 0 && (full || disconnected))
+            {
+                finish(begin, i);
+                ++meshlet_id;
+                begin          = i;
+                vertex_count   = 0;
+                triangle_count = 0;
+            }
+
+            for (uint32_t v : {a, b, c})
+            {
+                if (owner[v] != meshlet_id)
+                {
+                    owner[v] = meshlet_id;
+                    ++vertex_count;
+                }
+            }
+            ++triangle_count;
+        }
+
+        if (triangle_count > 0)
+            finish(begin, static_cast<uint32_t>(indices.size()));
+    }
+
+    void buildLods(CookedGeometry& geometry, size_t max_lods)
+    {
+        const auto base_count = static_cast<uint32_t>(geometry.indices.size());
+        geometry.lods.assign(1, MeshLod {0, base_count, 0.0f});
+
+        if (max_lods <= 1 || base_count < 3 || base_count % 3 != 0)
+            return;
+
+        std::vector<bool>    locked   = findLockedVertices(geometry.vertices, geometry.indices);
+        std::vector<Quadric> quadrics = computeQuadrics(geometry.vertices, geometry.indices);
+
+        // every level continues from the previous one, quadrics keep accumulating so errors are cumulative
+        std::vector<unsigned int> current = geometry.indices;
+        float                     error   = 0.0f;
+        for (size_t level = 1; level < max_lods; ++level)
+        {
+            const size_t previous_count = current.size();
+            const size_t target_count   = previous_count / 6 * 3;
+            if (target_count < g_min_lod_triangles * 3)
+                break;
+
+            error = std::max(error, simplify(current, geometry.vertices, locked, quadrics, target_count));
+
+            // locked borders and seams kept most of the mesh, further levels would not shrink either
+            if (current.size() * 4 > previous_count * 3)
+                break;
+
+            std::vector<unsigned int> level_indices = current;
+            optimizeTriangleOrder(level_indices, geometry.vertices);
+
+            geometry.lods.push_back({static_cast<uint32_t>(geometry.indices.size()),
+                                     static_cast<uint32_t>(level_indices.size()),
+                                     error});
+            geometry.indices.insert(geometry.indices.end(), level_indices.begin(), level_indices.end());
+        }
+    }
+} // namespace RealmEngine
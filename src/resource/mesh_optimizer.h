@@ -0,0 +1,63 @@
+#pragma once
+
+#include "resource/mesh_cache.h"
+#include "resource/model.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace RealmEngine
+{
+    // post-transform cache size the optimizer targets, small enough to hold on every gpu we run on
+    constexpr size_t g_vertex_cache_size = 16;
+
+    struct MeshOptimizeStats
+    {
+        size_t vertices_before {0};
+        size_t vertices_after {0};
+        float  acmr_before {0.0f}; // vertex shader invocations per triangle
+        float  acmr_after {0.0f};
+    };
+
+    /**
+     * @brief average cache miss ratio of a triangle list through a FIFO cache, 0.5 is the optimum on a regular grid
+     */
+    float computeACMR(const std::vector<unsigned int>& indices,
+                      size_t                           vertex_count,
+                      size_t                           cache_size = g_vertex_cache_size);
+
+    /**
+     * @brief reorder a triangle list for the post-transform cache, overdraw and vertex fetch, in that order
+     *
+     * Triangles are ordered with Tipsify and split into clusters at cache flushes, clusters are then
+     * sorted front-to-back by how far they face out of the mesh. Finally vertices are renumbered in
+     * first-use order and unreferenced vertices are dropped. Expects identical vertices already joined.
+     */
+    MeshOptimizeStats optimizeMesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices);
+
+    /**
+     * @brief cut a triangle list into consecutive parts referencing at most max_vertices vertices each
+     *
+     * Triangle order is kept and each part's vertices are in first-use order, so an optimized mesh stays optimized.
+     * Expects geometry without lods yet.
+     */
+    std::vector<CookedGeometry> splitMesh(const CookedGeometry& mesh, size_t max_vertices);
+
+    /**
+     * @brief split lod 0 of a dense mesh into meshlets with bounding spheres and normal cones
+     *
+     * Greedy over the optimized triangle order, a meshlet closes at g_meshlet_max_vertices /
+     * g_meshlet_max_triangles or when the order jumps to unconnected triangles. Index order is
+     * unchanged. Leaves meshlets empty below g_meshlet_min_mesh_triangles. Run before buildLods.
+     */
+    void buildMeshlets(CookedGeometry& geometry);
+
+    /**
+     * @brief append up to max_lods - 1 simplified levels to geometry, each about half the previous triangle count
+     *
+     * Quadric error edge collapse onto existing vertices, so all levels share the vertex buffer and only
+     * add an index range. Open borders and uv/normal seams are kept in place to avoid cracks.
+     * Stops early once a level no longer shrinks meaningfully. geometry.lods[0] is the input mesh.
+     */
+    void buildLods(CookedGeometry& geometry, size_t max_lods = g_max_lod_count);
+} // namespace RealmEngine
@@ -1,4 +1,7 @@
 #include "model.h"
+
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 #define GLFW_INCLUDE_NONE
@@ -8,33 +11,245 @@
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
+#include <glm/gtc/packing.hpp>
+
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+#include "assimp_io.h"
 #include "global.h"
+#include "mesh_cache.h"
+#include "mesh_optimizer.h"
+#include "render/staging_ring.h"
 
 namespace RealmEngine
 {
     unsigned int loadTextureFromFile(const char* path);
 
+    namespace
+    {
+        // everything a cooked mesh already went through
+        constexpr unsigned int g_import_flags =
+            aiProcess_Triangulate | aiProcess_CalcTangentSpace | aiProcess_GenNormals | aiProcess_JoinIdenticalVertices;
+
+        // size buffer for data, whose copy is queued in the staging ring, or uploaded right away if that is full
+        void uploadStaticBuffer(GLenum                                target,
+                                GLuint                                buffer,
+                                const void*                           data,
+                                size_t                                size,
+                                const std::shared_ptr<UploadTracker>& tracker)
+        {
+            glBufferData(target, static_cast<GLsizeiptr>(size), nullptr, GL_STATIC_DRAW);
+
+            StagingRing* staging = g_context.m_renderer->getStagingRing();
+            if (staging && staging->stageBuffer(buffer, 0, data, size, tracker))
+                return;
+            glBufferSubData(target, 0, static_cast<GLsizeiptr>(size), data);
+        }
+
+        // per-axis factor mapping [bounds_min, bounds_max] to [0, 65535], flat axes map to 0
+        glm::vec3 quantizationScale(const glm::vec3& bounds_min, const glm::vec3& bounds_max)
+        {
+            glm::vec3 extent = bounds_max - bounds_min;
+            return glm::vec3(extent.x > 0.0f ? 65535.0f / extent.x : 0.0f,
+                             extent.y > 0.0f ? 65535.0f / extent.y : 0.0f,
+                             extent.z > 0.0f ? 65535.0f / extent.z : 0.0f);
+        }
+
+        void quantizePosition(const glm::vec3& position,
+                              const glm::vec3& bounds_min,
+                              const glm::vec3& scale,
+                              uint16_t*        out)
+        {
+            glm::vec3 t = (position - bounds_min) * scale;
+            for (int c = 0; c < 3; ++c)
+            {
+                out[c] = static_cast<uint16_t>(std::clamp(t[c] + 0.5f, 0.0f, 65535.0f));
+            }
+        }
+
+        // unit vector -> snorm8 octahedral, same mapping the compact gbuffer uses
+        void encodeOctahedral(const glm::vec3& v, int8_t* out)
+        {
+            float l1 = std::abs(v.x) + std::abs(v.y) + std::abs(v.z);
+            if (l1 <= 0.0f)
+            {
+                out[0] = 0;
+                out[1] = 0;
+                return;
+            }
+
+            float x = v.x / l1;
+            float y = v.y / l1;
+            if (v.z < 0.0f)
+            {
+                float wrapped_x = (1.0f - std::abs(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+                float wrapped_y = (1.0f - std::abs(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+                x               = wrapped_x;
+                y               = wrapped_y;
+            }
+
+            out[0] = static_cast<int8_t>(std::round(std::clamp(x, -1.0f, 1.0f) * 127.0f));
+            out[1] = static_cast<int8_t>(std::round(std::clamp(y, -1.0f, 1.0f) * 127.0f));
+        }
+
+        void extractGeometry(const aiMesh* ai_mesh, CookedGeometry& out)
+        {
+            std::vector<Vertex>&       vertices = out.vertices;
+            std::vector<unsigned int>& indices  = out.indices;
+            vertices.reserve(ai_mesh->mNumVertices);
+            indices.reserve(static_cast<size_t>(ai_mesh->mNumFaces) * 3);
+
+            Vertex    vertex;
+            glm::vec3 vec3;
+            glm::vec2 vec2;
+            for (unsigned int i = 0; i < ai_mesh->mNumVertices; i++)
+            {
+                // load pos
+                vec3.x          = ai_mesh->mVertices[i].x;
+                vec3.y          = ai_mesh->mVertices[i].y;
+                vec3.z          = ai_mesh->mVertices[i].z;
+                vertex.position = vec3;
+
+                // load normal
+                if (ai_mesh->HasNormals())
+                {
+                    vec3.x        = ai_mesh->mNormals[i].x;
+                    vec3.y        = ai_mesh->mNormals[i].y;
+                    vec3.z        = ai_mesh->mNormals[i].z;
+                    vertex.normal = vec3;
+                }
+
+                // load tangent, only generated when the mesh has normals and uvs
+                if (ai_mesh->HasTangentsAndBitangents())
+                {
+                    vec3.x         = ai_mesh->mTangents[i].x;
+                    vec3.y         = ai_mesh->mTangents[i].y;
+                    vec3.z         = ai_mesh->mTangents[i].z;
+                    vertex.tangent = vec3;
+                }
+                else
+                    vertex.tangent = glm::vec3(0.0f);
+
+                // load uv
+                if (ai_mesh->mTextureCoords[0])
+                {
+                    vec2.x            = ai_mesh->mTextureCoords[0][i].x;
+                    vec2.y            = ai_mesh->mTextureCoords[0][i].y;
+                    vertex.tex_coords = vec2;
+                }
+                else
+                    vertex.tex_coords = glm::vec2(0.0f, 0.0f);
+
+                vertices.push_back(vertex);
+            }
+
+            // load ind for each face
+            aiFace face;
+            for (unsigned int i = 0; i < ai_mesh->mNumFaces; i++)
+            {
+                face = ai_mesh->mFaces[i];
+                for (unsigned int j = 0; j < face.mNumIndices; j++)
+                    indices.push_back(face.mIndices[j]);
+            }
+        }
+
+        // extract and optimize every mesh of the scene, indexed like aiScene::mMeshes
+        void cookMeshes(const aiScene* ai_scene, const std::string& path, std::vector<CookedMesh>& cooked)
+        {
+            cooked.resize(ai_scene->mNumMeshes);
+
+            size_t triangles       = 0;
+            float  misses_before   = 0.0f;
+            float  misses_after    = 0.0f;
+            size_t vertices_before = 0;
+            size_t vertices_after  = 0;
+            size_t lod_triangles   = 0;
+            for (unsigned int i = 0; i < ai_scene->mNumMeshes; i++)
+            {
+                CookedGeometry geometry;
+                extractGeometry(ai_scene->mMeshes[i], geometry);
+
+                MeshOptimizeStats stats = optimizeMesh(geometry.vertices, geometry.indices);
+
+                size_t mesh_triangles = geometry.indices.size() / 3;
+                triangles += mesh_triangles;
+                misses_before += stats.acmr_before * static_cast<float>(mesh_triangles);
+                misses_after += stats.acmr_after * static_cast<float>(mesh_triangles);
+                vertices_before += stats.vertices_before;
+                vertices_after += stats.vertices_after;
+
+                // too many vertices for 16-bit indices, draw it as several meshes sharing the material
+                std::vector<CookedGeometry>& parts = cooked[i].parts;
+                if (geometry.vertices.size() > g_max_short_index_vertices)
+                    parts = splitMesh(geometry, g_max_short_index_vertices);
+                else
+                    parts.push_back(std::move(geometry));
+
+                for (CookedGeometry& part : parts)
+                {
+                    buildMeshlets(part);
+                    buildLods(part);
+                    lod_triangles += part.lods.back().index_count / 3;
+                }
+            }
+
+            if (triangles > 0)
+            {
+                LOG_INFO("Cooked " + path + ": " + std::to_string(triangles) + " triangles, " +
+                         std::to_string(vertices_before) + " -> " + std::to_string(vertices_after) +
+                         " vertices, ACMR " +
+                         std::to_string(misses_before / static_cast<float>(triangles)) + " -> " +
+                         std::to_string(misses_after / static_cast<float>(triangles)) + ", coarsest lod " +
+                         std::to_string(lod_triangles) + " triangles");
+            }
+        }
+    } // namespace
+
+    glm::vec3 QuantizedGeometry::decodePosition(size_t          index,
+                                                const glm::vec3& bounds_min,
+                                                const glm::vec3& bounds_max) const
+    {
+        constexpr float inv_max = 1.0f / 65535.0f;
+
+        glm::vec3 t(static_cast<float>(positions[index * 3 + 0]) * inv_max,
+                    static_cast<float>(positions[index * 3 + 1]) * inv_max,
+                    static_cast<float>(positions[index * 3 + 2]) * inv_max);
+        return bounds_min + (bounds_max - bounds_min) * t;
+    }
+
     Mesh::Mesh(const std::vector<Vertex>&       verts,
                const std::vector<unsigned int>& inds,
-               const std::vector<Texture>&      texs) : m_verts(verts), m_inds(inds), m_texs(texs)
+               const std::vector<Texture>&      texs,
+               const GeometryOptions&           options,
+               const std::vector<MeshLod>&      lods) :
+        m_verts(verts), m_inds(inds), m_texs(texs), m_options(options), m_lods(lods)
     {
         setupMesh();
+        applyResidency();
     }
 
-    Mesh::Mesh(std::vector<Vertex>&& verts, std::vector<unsigned int>&& inds, std::vector<Texture>&& texs) :
-        m_verts(std::move(verts)), m_inds(std::move(inds)), m_texs(std::move(texs))
+    Mesh::Mesh(std::vector<Vertex>&&       verts,
+               std::vector<unsigned int>&& inds,
+               std::vector<Texture>&&      texs,
+               const GeometryOptions&      options,
+               std::vector<MeshLod>&&      lods) :
+        m_verts(std::move(verts)), m_inds(std::move(inds)), m_texs(std::move(texs)), m_options(options),
+        m_lods(std::move(lods))
     {
         setupMesh();
+        applyResidency();
     }
 
     Mesh::~Mesh() { cleanup(); }
 
     Mesh::Mesh(Mesh&& other) noexcept :
         m_verts(std::move(other.m_verts)), m_inds(std::move(other.m_inds)), m_texs(std::move(other.m_texs)),
-        m_vao_id(other.m_vao_id), m_vbo_id(other.m_vbo_id), m_ebo_id(other.m_ebo_id)
+        m_quantized(std::move(other.m_quantized)), m_options(other.m_options), m_lods(std::move(other.m_lods)),
+        m_meshlets(std::move(other.m_meshlets)), m_index_type(other.m_index_type),
+        m_vertex_count(other.m_vertex_count), m_bounds_min(other.m_bounds_min), m_bounds_max(other.m_bounds_max),
+        m_vao_id(other.m_vao_id), m_vbo_id(other.m_vbo_id), m_ebo_id(other.m_ebo_id),
+        m_uploads(std::move(other.m_uploads))
     {
         other.m_vao_id = 0;
         other.m_vbo_id = 0;
@@ -47,12 +262,21 @@ namespace RealmEngine
         {
             cleanup();
 
-            m_verts  = std::move(other.m_verts);
-            m_inds   = std::move(other.m_inds);
-            m_texs   = std::move(other.m_texs);
-            m_vao_id = other.m_vao_id;
-            m_vbo_id = other.m_vbo_id;
-            m_ebo_id = other.m_ebo_id;
+            m_verts        = std::move(other.m_verts);
+            m_inds         = std::move(other.m_inds);
+            m_texs         = std::move(other.m_texs);
+            m_quantized    = std::move(other.m_quantized);
+            m_options      = other.m_options;
+            m_lods         = std::move(other.m_lods);
+            m_meshlets     = std::move(other.m_meshlets);
+            m_index_type   = other.m_index_type;
+            m_vertex_count = other.m_vertex_count;
+            m_bounds_min   = other.m_bounds_min;
+            m_bounds_max   = other.m_bounds_max;
+            m_vao_id       = other.m_vao_id;
+            m_vbo_id       = other.m_vbo_id;
+            m_ebo_id       = other.m_ebo_id;
+            m_uploads      = std::move(other.m_uploads);
 
             other.m_vao_id = 0;
             other.m_vbo_id = 0;
@@ -63,17 +287,61 @@ namespace RealmEngine
 
     void Mesh::setupMesh()
     {
+        if (m_lods.empty())
+            m_lods.push_back({0, static_cast<uint32_t>(m_inds.size()), 0.0f});
+        m_vertex_count = static_cast<uint32_t>(m_verts.size());
+
+        if (!m_verts.empty())
+        {
+            m_bounds_min = m_verts[0].position;
+            m_bounds_max = m_verts[0].position;
+            for (const auto& vert : m_verts)
+            {
+                m_bounds_min = glm::min(m_bounds_min, vert.position);
+                m_bounds_max = glm::max(m_bounds_max, vert.position);
+            }
+        }
+
         glGenVertexArrays(1, &m_vao_id);
         glGenBuffers(1, &m_vbo_id);
         glGenBuffers(1, &m_ebo_id);
+        m_uploads = std::make_shared<UploadTracker>();
 
         glBindVertexArray(m_vao_id);
 
-        glBindBuffer(GL_ARRAY_BUFFER, m_vbo_id);
-        glBufferData(GL_ARRAY_BUFFER, m_verts.size() * sizeof(Vertex), &m_verts[0], GL_STATIC_DRAW);
+        if (m_options.vertex_format == VertexFormat::Compressed)
+            uploadCompressed();
+        else
+            uploadFloat32();
+
+        uploadIndices();
 
+        glBindVertexArray(0);
+    }
+
+    void Mesh::uploadIndices()
+    {
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo_id);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_inds.size() * sizeof(unsigned int), &m_inds[0], GL_STATIC_DRAW);
+
+        if (m_vertex_count > g_max_short_index_vertices)
+        {
+            m_index_type = GL_UNSIGNED_INT;
+            uploadStaticBuffer(
+                GL_ELEMENT_ARRAY_BUFFER, m_ebo_id, m_inds.data(), m_inds.size() * sizeof(unsigned int), m_uploads);
+            return;
+        }
+
+        // every index fits in 16 bits, half the memory and fetch bandwidth
+        m_index_type = GL_UNSIGNED_SHORT;
+        std::vector<uint16_t> short_inds(m_inds.begin(), m_inds.end());
+        uploadStaticBuffer(
+            GL_ELEMENT_ARRAY_BUFFER, m_ebo_id, short_inds.data(), short_inds.size() * sizeof(uint16_t), m_uploads);
+    }
+
+    void Mesh::uploadFloat32()
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo_id);
+        uploadStaticBuffer(GL_ARRAY_BUFFER, m_vbo_id, m_verts.data(), m_verts.size() * sizeof(Vertex), m_uploads);
 
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), nullptr);
@@ -86,49 +354,121 @@ namespace RealmEngine
         glVertexAttribPointer(
             2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, tex_coords)));
 
-        glBindVertexArray(0);
+        glEnableVertexAttribArray(3);
+        glVertexAttribPointer(
+            3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), reinterpret_cast<void*>(offsetof(Vertex, tangent)));
     }
 
-    void Mesh::draw(unsigned int shader_program) const
+    void Mesh::uploadCompressed()
     {
-        unsigned int diffuse_nr {1};
-        unsigned int normal_nr {1};
-        unsigned int specular_nr {1};
+        const glm::vec3 inv_scale = quantizationScale(m_bounds_min, m_bounds_max);
 
-        for (unsigned int i = 0; i < m_texs.size(); i++)
+        std::vector<CompressedVertex> packed(m_verts.size());
+        for (size_t i = 0; i < m_verts.size(); ++i)
         {
-            glActiveTexture(GL_TEXTURE0 + i);
+            const Vertex&     src = m_verts[i];
+            CompressedVertex& dst = packed[i];
+
+            quantizePosition(src.position, m_bounds_min, inv_scale, dst.position);
+            dst.flags = src.tangent != glm::vec3(0.0f) ? g_vertex_has_tangent : 0;
+            encodeOctahedral(src.normal, dst.normal);
+            encodeOctahedral(src.tangent, dst.tangent);
+            dst.tex_coords[0] = glm::packHalf1x16(src.tex_coords.x);
+            dst.tex_coords[1] = glm::packHalf1x16(src.tex_coords.y);
+        }
 
-            std::string number;
-            std::string name;
-            if (m_texs[i].type == Texture::Type::Diffuse)
-            {
-                name   = "texture_diffuse";
-                number = std::to_string(diffuse_nr++);
-            }
-            else if (m_texs[i].type == Texture::Type::Normal)
-            {
-                name   = "texture_normal";
-                number = std::to_string(normal_nr++);
-            }
-            else if (m_texs[i].type == Texture::Type::Specular)
+        glBindBuffer(GL_ARRAY_BUFFER, m_vbo_id);
+        uploadStaticBuffer(
+            GL_ARRAY_BUFFER, m_vbo_id, packed.data(), packed.size() * sizeof(CompressedVertex), m_uploads);
+
+        constexpr GLsizei stride = sizeof(CompressedVertex);
+
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, nullptr);
+
+        // xy = octahedral normal, zw = octahedral tangent
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(
+            1, 4, GL_BYTE, GL_TRUE, stride, reinterpret_cast<void*>(offsetof(CompressedVertex, normal)));
+
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(
+            2, 2, GL_HALF_FLOAT, GL_FALSE, stride, reinterpret_cast<void*>(offsetof(CompressedVertex, tex_coords)));
+
+        // integer attribute, location 3 holds the tangent in the Float32 layout
+        glEnableVertexAttribArray(3);
+        glVertexAttribIPointer(
+            3, 1, GL_UNSIGNED_SHORT, stride, reinterpret_cast<void*>(offsetof(CompressedVertex, flags)));
+    }
+
+    const MeshLod& Mesh::getLod(size_t lod) const { return m_lods[std::min(lod, m_lods.size() - 1)]; }
+
+    size_t Mesh::getIndexByteOffset(size_t lod) const
+    {
+        return static_cast<size_t>(getLod(lod).index_offset) * getIndexSize();
+    }
+
+    size_t Mesh::getIndexSize() const
+    {
+        return m_index_type == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    }
+
+    glm::vec3 Mesh::getPositionScale() const
+    {
+        if (m_options.vertex_format == VertexFormat::Compressed)
+            return m_bounds_max - m_bounds_min;
+        return glm::vec3(1.0f);
+    }
+
+    glm::vec3 Mesh::getPositionOffset() const
+    {
+        if (m_options.vertex_format == VertexFormat::Compressed)
+            return m_bounds_min;
+        return glm::vec3(0.0f);
+    }
+
+    /**
+     * @brief release cpu geometry the residency policy does not ask for, gpu buffers are the source of truth
+     */
+    void Mesh::applyResidency()
+    {
+        // cpu users (picking, collision) want the full mesh, coarser lods are gpu only
+        const size_t lod0_index_count = m_lods[0].index_count;
+
+        if (m_options.residency == GeometryResidency::KeepFull)
+        {
+            m_inds.resize(lod0_index_count);
+            m_inds.shrink_to_fit();
+            return;
+        }
+
+        if (m_options.residency == GeometryResidency::KeepQuantized)
+        {
+            const glm::vec3 inv_scale = quantizationScale(m_bounds_min, m_bounds_max);
+
+            m_quantized.positions.resize(m_verts.size() * 3);
+            for (size_t i = 0; i < m_verts.size(); ++i)
             {
-                name   = "texture_specular";
-                number = std::to_string(specular_nr++);
+                quantizePosition(m_verts[i].position, m_bounds_min, inv_scale, &m_quantized.positions[i * 3]);
             }
-
-            std::string uniform_name = name + number;
-            glUniform1i(glGetUniformLocation(shader_program, uniform_name.c_str()), i);
-            glBindTexture(GL_TEXTURE_2D, m_texs[i].id);
+            m_quantized.indices.assign(m_inds.begin(), m_inds.begin() + lod0_index_count);
         }
 
-        glBindVertexArray(m_vao_id);
-        glDrawElements(GL_TRIANGLES, m_inds.size(), GL_UNSIGNED_INT, nullptr);
-        glBindVertexArray(0);
+        // swap with empty, clear() alone keeps the capacity
+        std::vector<Vertex>().swap(m_verts);
+        std::vector<unsigned int>().swap(m_inds);
     }
 
+    bool Mesh::isUploaded() const { return !m_uploads || m_uploads->pending == 0; }
+
     void Mesh::cleanup()
     {
+        // queued copies must not land in a recycled buffer name
+        if (m_uploads)
+        {
+            m_uploads->released = true;
+            m_uploads.reset();
+        }
         if (m_vao_id != 0)
         {
             glDeleteVertexArrays(1, &m_vao_id);
@@ -148,10 +488,28 @@ namespace RealmEngine
 
     void Model::loadModel(const std::string& path)
     {
-        // load the whole scene
+        // assimp scratch, cpu vertex copies and decoded textures
+        MEMORY_SCOPE(MemoryTag::Resource);
+
+        static uint32_t next_material_id = 0;
+        m_material_id                    = ++next_material_id;
+
+        // cooked geometry skips every post-process step, assimp then only provides the node graph and materials
+        std::vector<CookedMesh> cooked;
+        bool                    from_cache = MeshCache::load(path, cooked);
+
+        // load the whole scene, the model and everything it references are read through the vfs
         Assimp::Importer importer;
-        const aiScene*   scene =
-            importer.ReadFile(path, aiProcess_Triangulate | aiProcess_CalcTangentSpace | aiProcess_GenNormals);
+        importer.SetIOHandler(new VfsIOSystem());
+
+        const aiScene* scene = importer.ReadFile(path, from_cache ? 0u : g_import_flags);
+        if (scene && from_cache && cooked.size() != scene->mNumMeshes)
+        {
+            LOG_WARN("Cooked mesh file for " + path + " does not match the scene, recooking");
+            from_cache = false;
+            cooked.clear();
+            scene = importer.ReadFile(path, g_import_flags);
+        }
 
         // pre-process
         if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
@@ -162,73 +520,56 @@ namespace RealmEngine
 
         m_store_dir = path.substr(0, path.find_last_of('/'));
 
+        if (!from_cache)
+        {
+            cookMeshes(scene, path, cooked);
+            MeshCache::store(path, cooked);
+        }
+
         // recursively process node in scene graph
-        processNode(scene->mRootNode, scene);
+        processNode(scene->mRootNode, scene, cooked);
+        computeBoundsAndLods();
     }
 
-    void Model::processNode(aiNode* ai_node, const aiScene* ai_scene)
+    void Model::computeBoundsAndLods()
     {
-        // front-order dfs
-        for (unsigned int i = 0; i < ai_node->mNumMeshes; i++)
+        m_lod_errors.clear();
+        for (size_t i = 0; i < m_meshes.size(); ++i)
         {
-            aiMesh* mesh = ai_scene->mMeshes[ai_node->mMeshes[i]];
-            m_meshes.push_back(processMesh(mesh, ai_scene));
+            const Mesh& mesh = m_meshes[i];
+            m_bounds_min     = i == 0 ? mesh.getBoundsMin() : glm::min(m_bounds_min, mesh.getBoundsMin());
+            m_bounds_max     = i == 0 ? mesh.getBoundsMax() : glm::max(m_bounds_max, mesh.getBoundsMax());
+
+            if (mesh.getLodCount() > m_lod_errors.size())
+                m_lod_errors.resize(mesh.getLodCount(), 0.0f);
         }
 
-        // recurse here
-        for (unsigned int i = 0; i < ai_node->mNumChildren; i++)
+        // meshes with fewer levels stay on their coarsest one, which counts toward the deeper levels too
+        for (const Mesh& mesh : m_meshes)
         {
-            processNode(ai_node->mChildren[i], ai_scene);
+            for (size_t lod = 0; lod < m_lod_errors.size(); ++lod)
+                m_lod_errors[lod] = std::max(m_lod_errors[lod], mesh.getLod(lod).error);
         }
     }
 
-    Mesh Model::processMesh(aiMesh* ai_mesh, const aiScene* ai_scene)
+    void Model::processNode(aiNode* ai_node, const aiScene* ai_scene, const std::vector<CookedMesh>& cooked)
     {
-        std::vector<Vertex>       vertices;
-        std::vector<unsigned int> indices;
-
-        Vertex    vertex;
-        glm::vec3 vec3;
-        glm::vec2 vec2;
-        for (unsigned int i = 0; i < ai_mesh->mNumVertices; i++)
+        // front-order dfs
+        for (unsigned int i = 0; i < ai_node->mNumMeshes; i++)
         {
-            // load pos
-            vec3.x          = ai_mesh->mVertices[i].x;
-            vec3.y          = ai_mesh->mVertices[i].y;
-            vec3.z          = ai_mesh->mVertices[i].z;
-            vertex.position = vec3;
-
-            // load normal
-            if (ai_mesh->HasNormals())
-            {
-                vec3.x        = ai_mesh->mNormals[i].x;
-                vec3.y        = ai_mesh->mNormals[i].y;
-                vec3.z        = ai_mesh->mNormals[i].z;
-                vertex.normal = vec3;
-            }
-
-            // load uv
-            if (ai_mesh->mTextureCoords[0])
-            {
-                vec2.x            = ai_mesh->mTextureCoords[0][i].x;
-                vec2.y            = ai_mesh->mTextureCoords[0][i].y;
-                vertex.tex_coords = vec2;
-            }
-            else
-                vertex.tex_coords = glm::vec2(0.0f, 0.0f);
-
-            vertices.push_back(vertex);
+            unsigned int mesh_index = ai_node->mMeshes[i];
+            processMesh(cooked[mesh_index], ai_scene->mMeshes[mesh_index], ai_scene);
         }
 
-        // load ind for each face
-        aiFace face;
-        for (unsigned int i = 0; i < ai_mesh->mNumFaces; i++)
+        // recurse here
+        for (unsigned int i = 0; i < ai_node->mNumChildren; i++)
         {
-            face = ai_mesh->mFaces[i];
-            for (unsigned int j = 0; j < face.mNumIndices; j++)
-                indices.push_back(face.mIndices[j]);
+            processNode(ai_node->mChildren[i], ai_scene, cooked);
         }
+    }
 
+    void Model::processMesh(const CookedMesh& cooked, aiMesh* ai_mesh, const aiScene* ai_scene)
+    {
         // load texture
         std::vector<Texture> textures;
         aiMaterial*          material     = ai_scene->mMaterials[ai_mesh->mMaterialIndex];
@@ -239,7 +580,11 @@ namespace RealmEngine
         std::vector<Texture> specular_maps = loadMaterialTextures(material, aiTextureType_SPECULAR);
         textures.insert(textures.end(), specular_maps.begin(), specular_maps.end());
 
-        return Mesh(std::move(vertices), std::move(indices), std::move(textures));
+        for (const CookedGeometry& part : cooked.parts)
+        {
+            m_meshes.emplace_back(part.vertices, part.indices, textures, m_options, part.lods);
+            m_meshes.back().setMeshlets(part.meshlets);
+        }
     }
 
     std::vector<Texture> Model::loadMaterialTextures(aiMaterial* ai_mat, aiTextureType ai_type)
@@ -284,55 +629,90 @@ namespace RealmEngine
         return textures;
     }
 
-    void Model::draw(unsigned int shader_program) const
+    Model::~Model() { releaseTextures(); }
+
+    Model& Model::operator=(Model&& other) noexcept
     {
-        for (const auto& mesh : m_meshes)
-            mesh.draw(shader_program);
+        if (this != &other)
+        {
+            releaseTextures();
+
+            m_material_id = other.m_material_id;
+            m_options     = other.m_options;
+            m_textures    = std::move(other.m_textures);
+            m_meshes      = std::move(other.m_meshes);
+            m_lod_errors  = std::move(other.m_lod_errors);
+            m_bounds_min  = other.m_bounds_min;
+            m_bounds_max  = other.m_bounds_max;
+            m_store_dir   = std::move(other.m_store_dir);
+
+            other.m_textures.clear();
+        }
+        return *this;
     }
 
-    bool Model::loadFromFile(const std::string& path)
+    // textures belong to the model that loaded them, meshes only hold their names
+    void Model::releaseTextures()
     {
-        m_meshes.clear();
+        // once the renderer is terminated the streamer has deleted every texture itself
+        TextureStreamer* streamer = g_context.m_renderer ? g_context.m_renderer->getTextureStreamer() : nullptr;
+        if (streamer)
+        {
+            for (const Texture& texture : m_textures)
+                streamer->destroyTexture(texture.id);
+        }
         m_textures.clear();
+    }
+
+    bool Model::isUploaded() const
+    {
+        const TextureStreamer* streamer = g_context.m_renderer->getTextureStreamer();
+        return std::all_of(m_meshes.begin(), m_meshes.end(), [](const Mesh& mesh) { return mesh.isUploaded(); }) &&
+               std::all_of(m_textures.begin(), m_textures.end(), [streamer](const Texture& texture) {
+                   return streamer->isUploaded(texture.id);
+               });
+    }
+
+    bool Model::loadFromFile(const std::string& path, const GeometryOptions& options)
+    {
+        m_options = options;
+        m_meshes.clear();
+        releaseTextures();
         loadModel(path);
         return !m_meshes.empty();
     }
 
     unsigned int loadTextureFromFile(const char* path)
     {
-        unsigned int texture_id;
-        glGenTextures(1, &texture_id);
-
-        int            width, height, nr_components;
-        unsigned char* data = stbi_load(path, &width, &height, &nr_components, 0);
-
-        if (data)
+        // decode straight from the mapped (or decompressed) file, stbi never touches the disk
+        FileData       file;
+        int            width = 0, height = 0, nr_components = 0;
+        unsigned char* data = nullptr;
+        if (g_context.m_vfs->read(path, file))
         {
-            GLenum format;
-            if (nr_components == 1)
-                format = GL_RED;
-            else if (nr_components == 3)
-                format = GL_RGB;
-            else if (nr_components == 4)
-                format = GL_RGBA;
-
-            glBindTexture(GL_TEXTURE_2D, texture_id);
-            glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-            glGenerateMipmap(GL_TEXTURE_2D);
-
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-            stbi_image_free(data);
+            const auto* bytes = reinterpret_cast<const stbi_uc*>(file.data());
+            int         size  = static_cast<int>(file.size());
+
+            // grey+alpha has no matching upload format, expand it
+            int channels = 0;
+            if (stbi_info_from_memory(bytes, size, &width, &height, &channels) && channels == 2)
+                channels = 4;
+            data = stbi_load_from_memory(bytes, size, &width, &height, &nr_components, channels);
+            if (channels != 0)
+                nr_components = channels;
         }
-        else
+
+        if (!data)
         {
             LOG_ERROR("Texture failed to load at path", path);
-            stbi_image_free(data);
+            return 0;
         }
 
+        // only the small mips are uploaded now, the rest streams in once the texture is seen up close
+        unsigned int texture_id =
+            g_context.m_renderer->getTextureStreamer()->createTexture(path, data, width, height, nr_components);
+        stbi_image_free(data);
+
         return texture_id;
     }
 } // namespace RealmEngine
\ No newline at end of file
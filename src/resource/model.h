@@ -6,24 +6,98 @@
 
 #include <glm/glm.hpp>
 
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace RealmEngine
 {
+    struct CookedMesh;
+    struct UploadTracker;
 
     struct Vertex
     {
         glm::vec3 position;
         glm::vec3 normal;
         glm::vec2 tex_coords;
+        glm::vec3 tangent;
     };
 
+    // VertexFormat::Compressed, decoded in gbuffer.vert / depth_prepass.vert (VERTEX_COMPRESSED)
+    struct CompressedVertex
+    {
+        uint16_t position[3]; // unorm16, position = value * Mesh::getPositionScale() + Mesh::getPositionOffset()
+        uint16_t flags;         // g_vertex_has_tangent, an all-zero tangent is a valid +Z direction
+        int8_t   normal[2];     // snorm8 octahedral
+        int8_t   tangent[2];    // snorm8 octahedral
+        uint16_t tex_coords[2]; // half float
+    };
+    static_assert(sizeof(CompressedVertex) == 16, "CompressedVertex must stay tightly packed");
+
+    // CompressedVertex::flags, must match VERTEX_HAS_TANGENT in gbuffer.vert
+    constexpr uint16_t g_vertex_has_tangent = 1;
+
+    /**
+     * @brief compact cpu copy of mesh geometry, positions as unorm16 within the mesh bounds
+     */
+    struct QuantizedGeometry
+    {
+        std::vector<uint16_t> positions; // xyz triplets
+        std::vector<uint32_t> indices;
+
+        size_t    getVertexCount() const { return positions.size() / 3; }
+        glm::vec3 decodePosition(size_t index, const glm::vec3& bounds_min, const glm::vec3& bounds_max) const;
+    };
+
+    // contiguous range of a Mesh's index buffer, lod 0 is the full mesh
+    struct MeshLod
+    {
+        uint32_t index_offset; // in indices
+        uint32_t index_count;
+        float    error; // how far the simplified surface may be from lod 0, in mesh units
+    };
+
+    constexpr size_t g_max_lod_count = 5;
+
+    /**
+     * @brief small cluster of lod 0 triangles, culled as a whole against the view
+     *
+     * Triangles of a meshlet are one contiguous index range, consecutive meshlets are consecutive
+     * ranges, so visible runs merge into single draws. Bounds are in mesh space.
+     */
+    struct Meshlet
+    {
+        glm::vec3 center;
+        float     radius;
+        glm::vec3 cone_axis;   // average facing of the triangles
+        float     cone_cutoff; // sin of the normal cone half-angle, 1 = never backface culled
+        uint32_t  index_offset;
+        uint32_t  index_count;
+    };
+
+    constexpr size_t g_meshlet_max_vertices  = 64;
+    constexpr size_t g_meshlet_max_triangles = 124;
+    // sparser meshes are drawn whole, per-cluster culling would cost more than it saves
+    constexpr size_t g_meshlet_min_mesh_triangles = 4096;
+
+    // meshes up to this many vertices are drawn with 16-bit indices, larger ones are split at load
+    constexpr size_t g_max_short_index_vertices = 65536;
+
     class Mesh
     {
     public:
-        Mesh(const std::vector<Vertex>& verts, const std::vector<unsigned int>& inds, const std::vector<Texture>& texs);
-        Mesh(std::vector<Vertex>&& verts, std::vector<unsigned int>&& inds, std::vector<Texture>&& texs);
+        // without lods the whole index list is lod 0
+        Mesh(const std::vector<Vertex>&       verts,
+             const std::vector<unsigned int>& inds,
+             const std::vector<Texture>&      texs,
+             const GeometryOptions&           options = {},
+             const std::vector<MeshLod>&      lods    = {});
+        Mesh(std::vector<Vertex>&&       verts,
+             std::vector<unsigned int>&& inds,
+             std::vector<Texture>&&      texs,
+             const GeometryOptions&      options = {},
+             std::vector<MeshLod>&&      lods    = {});
         ~Mesh();
 
         Mesh(const Mesh&)            = delete;
@@ -31,21 +105,60 @@ namespace RealmEngine
         Mesh(Mesh&& other) noexcept;
         Mesh& operator=(Mesh&& other) noexcept;
 
-        void draw(unsigned int shader_program) const;
-
+        // empty unless the mesh was created with GeometryResidency::KeepFull, indices are lod 0 only
         const std::vector<Vertex>&       getVertices() const { return m_verts; }
         const std::vector<unsigned int>& getIndices() const { return m_inds; }
-        const std::vector<Texture>&      getTextures() const { return m_texs; }
+        // empty unless the mesh was created with GeometryResidency::KeepQuantized
+        const QuantizedGeometry& getQuantizedGeometry() const { return m_quantized; }
+
+        // lod 0 only, empty for meshes too sparse to be worth culling per cluster
+        const std::vector<Meshlet>& getMeshlets() const { return m_meshlets; }
+        void                        setMeshlets(std::vector<Meshlet> meshlets) { m_meshlets = std::move(meshlets); }
+
+        const std::vector<Texture>& getTextures() const { return m_texs; }
+        unsigned int                getVAO() const { return m_vao_id; }
+        size_t                      getLodCount() const { return m_lods.size(); }
+        const MeshLod&              getLod(size_t lod) const; // past the last level clamps to the coarsest
+        size_t                      getIndexByteOffset(size_t lod) const;
+        size_t                      getIndexSize() const; // bytes per index
+        uint32_t                    getIndexCount(size_t lod = 0) const { return getLod(lod).index_count; }
+        unsigned int                getIndexType() const { return m_index_type; } // GL_UNSIGNED_SHORT / _INT
+        uint32_t                    getVertexCount() const { return m_vertex_count; }
+        GeometryResidency           getResidency() const { return m_options.residency; }
+        VertexFormat                getVertexFormat() const { return m_options.vertex_format; }
+        const glm::vec3&            getBoundsMin() const { return m_bounds_min; }
+        const glm::vec3&            getBoundsMax() const { return m_bounds_max; }
+
+        // vertex and index data reach the gpu through the staging ring, drawing before this shows garbage
+        bool isUploaded() const;
+
+        // decode of attribute 0, identity for Float32
+        glm::vec3 getPositionScale() const;
+        glm::vec3 getPositionOffset() const;
 
     private:
         std::vector<Vertex>       m_verts;
         std::vector<unsigned int> m_inds;
         std::vector<Texture>      m_texs;
+        QuantizedGeometry         m_quantized;
+        GeometryOptions           m_options;
+        std::vector<MeshLod>      m_lods;
+        std::vector<Meshlet>      m_meshlets;
+        unsigned int              m_index_type {0};
+        uint32_t                  m_vertex_count {0};
+        glm::vec3                 m_bounds_min {0.0f};
+        glm::vec3                 m_bounds_max {0.0f};
         unsigned int              m_vao_id {0};
         unsigned int              m_vbo_id {0};
         unsigned int              m_ebo_id {0};
 
+        std::shared_ptr<UploadTracker> m_uploads; // buffer contents still queued in the staging ring
+
         void setupMesh();
+        void uploadIndices();
+        void uploadFloat32();
+        void uploadCompressed();
+        void applyResidency();
         void cleanup();
     };
 
@@ -53,29 +166,52 @@ namespace RealmEngine
     {
     public:
         Model() = default;
-        explicit Model(const std::string& path) { loadModel(path); };
-        ~Model() = default;
+        explicit Model(const std::string& path, const GeometryOptions& options = {}) : m_options(options)
+        {
+            loadModel(path);
+        };
+        ~Model();
 
         Model(const Model&)            = delete; // copy construct not allowed
         Model& operator=(const Model&) = delete;
         Model(Model&&)                 = default; // move construct allowed
-        Model& operator=(Model&&)      = default;
+        Model& operator=(Model&& other) noexcept;
 
-        void draw(unsigned int shader_program) const;
-        bool loadFromFile(const std::string& path);
+        bool loadFromFile(const std::string& path, const GeometryOptions& options = {});
 
         const std::vector<Mesh>&    getMeshes() const { return m_meshes; }
         const std::vector<Texture>& getTextures() const { return m_textures; }
         const std::string&          getDirectory() const { return m_store_dir; }
+        const GeometryOptions&      getGeometryOptions() const { return m_options; }
+        VertexFormat                getVertexFormat() const { return m_options.vertex_format; }
+        const glm::vec3&            getBoundsMin() const { return m_bounds_min; }
+        const glm::vec3&            getBoundsMax() const { return m_bounds_max; }
+
+        // lod count of the most detailed mesh, and the largest error any mesh has at that level
+        size_t getLodCount() const { return m_lod_errors.size(); }
+        float  getLodError(size_t lod) const { return m_lod_errors[lod]; }
+
+        // identifies this model's vao/texture set, used to batch draws in sort keys
+        uint32_t getMaterialId() const { return m_material_id; }
+
+        // every mesh is uploaded, see Mesh::isUploaded, and so are the permanent mips of every texture
+        bool isUploaded() const;
 
     private:
+        uint32_t             m_material_id {0};
+        GeometryOptions      m_options;
         std::vector<Texture> m_textures;
         std::vector<Mesh>    m_meshes;
+        std::vector<float>   m_lod_errors;
+        glm::vec3            m_bounds_min {0.0f};
+        glm::vec3            m_bounds_max {0.0f};
         std::string          m_store_dir;
 
         void                 loadModel(const std::string& path);
+        void                 releaseTextures();
+        void                 computeBoundsAndLods();
         std::vector<Texture> loadMaterialTextures(aiMaterial* ai_mat, aiTextureType ai_type);
-        void                 processNode(aiNode* ai_node, const aiScene* ai_scene);
-        Mesh                 processMesh(aiMesh* ai_mesh, const aiScene* ai_scene);
+        void processNode(aiNode* ai_node, const aiScene* ai_scene, const std::vector<CookedMesh>& cooked);
+        void processMesh(const CookedMesh& cooked, aiMesh* ai_mesh, const aiScene* ai_scene);
     };
 } // namespace RealmEngine
\ No newline at end of file
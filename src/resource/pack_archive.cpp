@@ -0,0 +1,296 @@
+#include "pack_archive.h"
+
+#include "global.h"
+#include "resource/lz4.h"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace RealmEngine
+{
+    namespace
+    {
+        void writePadding(std::ofstream& out, uint64_t& offset, size_t alignment)
+        {
+            static constexpr char zeros[16] {};
+            size_t                padding = (alignment - offset % alignment) % alignment;
+            out.write(zeros, static_cast<std::streamsize>(padding));
+            offset += padding;
+        }
+    } // namespace
+
+    uint64_t PackArchive::hashPath(std::string_view path)
+    {
+        // FNV-1a 64
+        uint64_t hash = 14695981039346656037ull;
+        for (char c : path)
+        {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    bool PackArchive::open(const std::string& path)
+    {
+        auto file = std::make_shared<MappedFile>();
+        if (!file->open(path))
+            return false;
+
+        const std::byte* base = file->data();
+        const size_t     size = file->size();
+
+        Header header {};
+        if (size < sizeof(Header))
+        {
+            LOG_ERROR("Archive " + path + " is truncated");
+            return false;
+        }
+        std::memcpy(&header, base, sizeof(header));
+
+        if (header.magic != m_MAGIC || header.version != m_VERSION)
+        {
+            LOG_ERROR("Archive " + path + " has an unknown format or version");
+            return false;
+        }
+
+        uint64_t index_size = static_cast<uint64_t>(header.entry_count) * sizeof(Entry);
+        // offset and length compared separately, their sum could wrap
+        if (header.index_offset % alignof(Entry) != 0 || header.index_offset > size ||
+            index_size > size - header.index_offset || header.names_offset > size)
+        {
+            LOG_ERROR("Archive " + path + " has a corrupt index");
+            return false;
+        }
+
+        m_entries     = reinterpret_cast<const Entry*>(base + header.index_offset);
+        m_entry_count = header.entry_count;
+        m_names       = reinterpret_cast<const char*>(base + header.names_offset);
+        m_names_size  = size - header.names_offset;
+
+        // validate once so reads never have to bounds check
+        for (uint32_t i = 0; i < m_entry_count; ++i)
+        {
+            const Entry& entry = m_entries[i];
+
+            // read() allocates original_size for compressed entries, bound it by what lz4 can expand to
+            bool sizes_valid = entry.original_size == entry.stored_size;
+            if (entry.flags & m_FLAG_COMPRESSED)
+                sizes_valid = entry.original_size <= m_MAX_ENTRY_SIZE &&
+                              entry.original_size / m_LZ4_MAX_RATIO <= entry.stored_size;
+
+            if (entry.data_offset > size || entry.stored_size > size - entry.data_offset || !sizes_valid ||
+                static_cast<size_t>(entry.name_offset) + entry.name_length > m_names_size)
+            {
+                LOG_ERROR("Archive " + path + " has a corrupt entry");
+                m_entries     = nullptr;
+                m_entry_count = 0;
+                return false;
+            }
+        }
+
+        m_file = std::move(file);
+        m_path = path;
+        return true;
+    }
+
+    size_t PackArchive::getEntryCount() const { return m_entry_count; }
+
+    std::string_view PackArchive::getName(const Entry& entry) const
+    {
+        return {m_names + entry.name_offset, entry.name_length};
+    }
+
+    const PackArchive::Entry* PackArchive::findEntry(std::string_view path) const
+    {
+        uint64_t     hash  = hashPath(path);
+        const Entry* begin = m_entries;
+        const Entry* end   = m_entries + m_entry_count;
+
+        auto it = std::lower_bound(
+            begin, end, hash, [](const Entry& entry, uint64_t value) { return entry.path_hash < value; });
+        for (; it != end && it->path_hash == hash; ++it)
+        {
+            if (getName(*it) == path)
+                return it;
+        }
+        return nullptr;
+    }
+
+    bool PackArchive::read(std::string_view path, FileData& data) const
+    {
+        const Entry* entry = findEntry(path);
+        if (!entry)
+            return false;
+
+        if (!(entry->flags & m_FLAG_COMPRESSED))
+        {
+            data = FileData(m_file, entry->data_offset, entry->stored_size);
+            return true;
+        }
+
+        std::vector<std::byte> buffer(entry->original_size);
+        if (!lz4Decompress(m_file->data() + entry->data_offset, entry->stored_size, buffer.data(), buffer.size()))
+        {
+            LOG_ERROR("Archive " + m_path + " has a corrupt entry " + std::string(path));
+            return false;
+        }
+
+        data = FileData(std::move(buffer));
+        return true;
+    }
+
+    bool PackArchive::stat(std::string_view path, FileInfo& info) const
+    {
+        const Entry* entry = findEntry(path);
+        if (!entry)
+            return false;
+
+        info.size       = entry->original_size;
+        info.write_time = entry->write_time;
+        return true;
+    }
+
+    bool PackArchive::packDirectory(const std::string& source_dir, const std::string& archive_path)
+    {
+        namespace fs = std::filesystem;
+
+        std::error_code ec;
+        if (!fs::is_directory(source_dir, ec))
+        {
+            LOG_ERROR("Cannot pack " + source_dir + ", not a directory");
+            return false;
+        }
+
+        struct Source
+        {
+            std::string name;
+            fs::path    path;
+            uint64_t    hash;
+        };
+
+        std::vector<Source> sources;
+        const fs::path      archive_full = fs::weakly_canonical(archive_path, ec);
+        fs::recursive_directory_iterator it(source_dir, ec);
+        for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec))
+        {
+            std::error_code entry_ec;
+            if (!it->is_regular_file(entry_ec) || fs::weakly_canonical(it->path(), entry_ec) == archive_full)
+                continue;
+
+            std::string name = it->path().lexically_relative(source_dir).generic_string();
+            if (name.size() > UINT16_MAX || (name.size() >= 4 && name.compare(name.size() - 4, 4, ".tmp") == 0))
+                continue;
+
+            sources.push_back({name, it->path(), hashPath(name)});
+        }
+        if (ec)
+        {
+            LOG_ERROR("Cannot pack " + source_dir + ": " + ec.message());
+            return false;
+        }
+
+        std::sort(sources.begin(), sources.end(), [](const Source& a, const Source& b) {
+            return a.hash != b.hash ? a.hash < b.hash : a.name < b.name;
+        });
+
+        // write to a temporary and rename, a mounted archive must never be seen half written
+        std::string   temp_path = archive_path + ".tmp";
+        std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+        if (!out)
+        {
+            LOG_ERROR("Could not write archive " + archive_path);
+            return false;
+        }
+
+        Header header {};
+        header.magic       = m_MAGIC;
+        header.version     = m_VERSION;
+        header.entry_count = static_cast<uint32_t>(sources.size());
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<Entry> entries;
+        std::string        names;
+        uint64_t           offset        = sizeof(Header);
+        uint64_t           original_size = 0;
+        entries.reserve(sources.size());
+
+        for (const Source& source : sources)
+        {
+            MappedFile file;
+            auto       write_time = fs::last_write_time(source.path, ec);
+            if (ec || !file.open(source.path.string()))
+            {
+                LOG_ERROR("Could not read " + source.path.string());
+                out.close();
+                fs::remove(temp_path, ec);
+                return false;
+            }
+
+            writePadding(out, offset, m_DATA_ALIGNMENT);
+
+            Entry entry {};
+            entry.path_hash     = source.hash;
+            entry.data_offset   = offset;
+            entry.original_size = file.size();
+            entry.write_time    = static_cast<int64_t>(write_time.time_since_epoch().count());
+            entry.name_offset   = static_cast<uint32_t>(names.size());
+            entry.name_length   = static_cast<uint16_t>(source.name.size());
+
+            const std::byte*       payload      = file.data();
+            size_t                 payload_size = file.size();
+            std::vector<std::byte> compressed;
+            if (file.size() > 0)
+            {
+                compressed = lz4Compress(file.data(), file.size());
+                if (compressed.size() <= file.size() - file.size() / 8)
+                {
+                    payload      = compressed.data();
+                    payload_size = compressed.size();
+                    entry.flags |= m_FLAG_COMPRESSED;
+                }
+            }
+
+            entry.stored_size = payload_size;
+            out.write(reinterpret_cast<const char*>(payload), static_cast<std::streamsize>(payload_size));
+            offset += payload_size;
+            original_size += file.size();
+
+            entries.push_back(entry);
+            names += source.name;
+        }
+
+        writePadding(out, offset, alignof(Entry));
+        header.index_offset = offset;
+        header.names_offset = offset + entries.size() * sizeof(Entry);
+        out.write(reinterpret_cast<const char*>(entries.data()),
+                  static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+        out.write(names.data(), static_cast<std::streamsize>(names.size()));
+
+        out.seekp(0);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.close();
+        if (!out)
+        {
+            LOG_ERROR("Could not write archive " + archive_path);
+            fs::remove(temp_path, ec);
+            return false;
+        }
+
+        fs::rename(temp_path, archive_path, ec);
+        if (ec)
+        {
+            LOG_ERROR("Could not write archive " + archive_path + ": " + ec.message());
+            fs::remove(temp_path, ec);
+            return false;
+        }
+
+        LOG_INFO("Packed " + std::to_string(entries.size()) + " files from " + source_dir + " into " + archive_path +
+                 ", " + std::to_string(original_size) + " -> " + std::to_string(header.names_offset) + " bytes");
+        return true;
+    }
+} // namespace RealmEngine
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "resource/mapped_file.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace RealmEngine
+{
+    /**
+     * @brief read-only packed archive (.pak), memory mapped once and read without further syscalls
+     *
+     * Layout: header, entry data (each 16-byte aligned, optionally LZ4 compressed), index sorted by
+     * path hash, name table. Lookup is a binary search on the FNV-1a hash of the archive-relative
+     * path, names are kept to resolve hash collisions. Uncompressed entries are returned as views
+     * into the mapping. Const member functions are safe to call from any thread.
+     */
+    class PackArchive
+    {
+    public:
+        bool open(const std::string& path);
+
+        bool read(std::string_view path, FileData& data) const;
+        bool stat(std::string_view path, FileInfo& info) const;
+        bool contains(std::string_view path) const { return findEntry(path) != nullptr; }
+
+        size_t getEntryCount() const;
+
+        /**
+         * @brief pack every regular file below source_dir into archive_path
+         *
+         * Entries are LZ4 compressed only where that saves at least an eighth, already compressed
+         * formats (png, jpg) are stored as is and stay zero-copy. Entries keep the source write time,
+         * so caches keyed on it (MeshCache) stay valid when their source moves into the archive.
+         */
+        static bool packDirectory(const std::string& source_dir, const std::string& archive_path);
+
+        static uint64_t hashPath(std::string_view path);
+
+    private:
+        struct Header
+        {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t entry_count;
+            uint32_t reserved;
+            uint64_t index_offset;
+            uint64_t names_offset;
+        };
+
+        struct Entry
+        {
+            uint64_t path_hash;
+            uint64_t data_offset;
+            uint64_t stored_size;
+            uint64_t original_size;
+            int64_t  write_time;
+            uint32_t name_offset;
+            uint16_t name_length;
+            uint16_t flags;
+        };
+
+        static constexpr uint32_t m_MAGIC           = 0x4B415052; // "RPAK"
+        static constexpr uint32_t m_VERSION         = 1;
+        static constexpr uint16_t m_FLAG_COMPRESSED = 1 << 0;
+        static constexpr size_t   m_DATA_ALIGNMENT  = 16;
+        // an lz4 block expands at most ~255x, anything claiming more is corrupt
+        static constexpr uint64_t m_LZ4_MAX_RATIO   = 255;
+        static constexpr uint64_t m_MAX_ENTRY_SIZE  = uint64_t(1) << 32;
+
+        const Entry*     findEntry(std::string_view path) const;
+        std::string_view getName(const Entry& entry) const;
+
+        std::shared_ptr<MappedFile> m_file;
+        std::string                 m_path;
+        const Entry*                m_entries {nullptr};
+        uint32_t                    m_entry_count {0};
+        const char*                 m_names {nullptr};
+        size_t                      m_names_size {0};
+    };
+} // namespace RealmEngine
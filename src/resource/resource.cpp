@@ -28,16 +28,18 @@ namespace RealmEngine
         return texture;
     }
 
-    std::shared_ptr<Model> Resource::loadModel(const std::string& path)
+    std::shared_ptr<Model> Resource::loadModel(const std::string& path, const GeometryOptions& options)
     {
         auto it = m_model_cache.find(path);
         if (it != m_model_cache.end())
         {
+            if (it->second->getGeometryOptions() != options)
+                LOG_WARN("Model " + path + " already cached with different geometry options");
             return it->second;
         }
 
         auto model = std::make_shared<Model>();
-        model->loadFromFile(path);
+        model->loadFromFile(path, options);
         m_model_cache[path] = model;
         return model;
     }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -23,6 +25,36 @@ namespace RealmEngine
         std::string  path {0};
     };
 
+    // what a Mesh keeps in cpu memory once its geometry is uploaded
+    enum class GeometryResidency : uint8_t
+    {
+        GPUOnly,       // drop cpu copies after upload (default)
+        KeepFull,      // keep float vertices and 32-bit indices
+        KeepQuantized, // keep 16-bit positions within mesh bounds and indices, enough for picking/collision
+    };
+
+    // gpu vertex layout of a Mesh, see Vertex / CompressedVertex
+    enum class VertexFormat : uint8_t
+    {
+        Float32,    // 44 bytes: float position, normal, tangent, uv
+        Compressed, // 16 bytes: unorm16 position in mesh bounds, octahedral normal+tangent, half uv
+    };
+
+    constexpr size_t g_vertex_format_count = 2;
+
+    // how a model's meshes are built and stored, fixed at load time
+    struct GeometryOptions
+    {
+        GeometryResidency residency {GeometryResidency::GPUOnly};
+        VertexFormat      vertex_format {VertexFormat::Compressed};
+
+        bool operator==(const GeometryOptions& other) const
+        {
+            return residency == other.residency && vertex_format == other.vertex_format;
+        }
+        bool operator!=(const GeometryOptions& other) const { return !(*this == other); }
+    };
+
     class Resource
     {
     public:
@@ -30,7 +62,7 @@ namespace RealmEngine
         void terminate();
 
         std::shared_ptr<Texture> loadTexture(const std::string& path);
-        std::shared_ptr<Model>   loadModel(const std::string& path);
+        std::shared_ptr<Model>   loadModel(const std::string& path, const GeometryOptions& options = {});
         std::shared_ptr<Shader>  loadShader(const std::string& name);
 
         void clearCache();
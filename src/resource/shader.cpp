@@ -4,16 +4,19 @@
 #include <GLFW/glfw3.h>
 #include <glad/gl.h>
 
-#include <fstream>
+#include <algorithm>
 #include <iostream>
-#include <sstream>
+
+#include "global.h"
 
 namespace RealmEngine
 {
-    Shader::Shader(const std::string& vertexPath, const std::string& fragmentPath)
+    Shader::Shader(const std::string&              vertexPath,
+                   const std::string&              fragmentPath,
+                   const std::vector<std::string>& defines)
     {
-        std::string vertex_code   = loadShaderSource(vertexPath);
-        std::string fragment_code = loadShaderSource(fragmentPath);
+        std::string vertex_code   = injectDefines(loadShaderSource(vertexPath), defines);
+        std::string fragment_code = injectDefines(loadShaderSource(fragmentPath), defines);
 
         const char* v_shader_code = vertex_code.c_str();
         const char* f_shader_code = fragment_code.c_str();
@@ -46,41 +49,41 @@ namespace RealmEngine
 
     unsigned int Shader::getShaderProgram() const { return m_program; }
 
-    void Shader::setBool(const std::string& name, bool value)
+    void Shader::setBool(std::string_view name, bool value)
     {
         glUniform1i(getUniformLocation(name), static_cast<int>(value));
     }
 
-    void Shader::setInt(const std::string& name, int value) { glUniform1i(getUniformLocation(name), value); }
+    void Shader::setInt(std::string_view name, int value) { glUniform1i(getUniformLocation(name), value); }
 
-    void Shader::setFloat(const std::string& name, float value) { glUniform1f(getUniformLocation(name), value); }
+    void Shader::setFloat(std::string_view name, float value) { glUniform1f(getUniformLocation(name), value); }
 
-    void Shader::setVec2(const std::string& name, const glm::vec2& value)
+    void Shader::setVec2(std::string_view name, const glm::vec2& value)
     {
         glUniform2fv(getUniformLocation(name), 1, &value[0]);
     }
 
-    void Shader::setVec3(const std::string& name, const glm::vec3& value)
+    void Shader::setVec3(std::string_view name, const glm::vec3& value)
     {
         glUniform3fv(getUniformLocation(name), 1, &value[0]);
     }
 
-    void Shader::setVec4(const std::string& name, const glm::vec4& value)
+    void Shader::setVec4(std::string_view name, const glm::vec4& value)
     {
         glUniform4fv(getUniformLocation(name), 1, &value[0]);
     }
 
-    void Shader::setMat2(const std::string& name, const glm::mat2& mat)
+    void Shader::setMat2(std::string_view name, const glm::mat2& mat)
     {
         glUniformMatrix2fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
 
-    void Shader::setMat3(const std::string& name, const glm::mat3& mat)
+    void Shader::setMat3(std::string_view name, const glm::mat3& mat)
     {
         glUniformMatrix3fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
 
-    void Shader::setMat4(const std::string& name, const glm::mat4& mat)
+    void Shader::setMat4(std::string_view name, const glm::mat4& mat)
     {
         glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, &mat[0][0]);
     }
@@ -111,21 +114,56 @@ namespace RealmEngine
 
     std::string Shader::loadShaderSource(const std::string& path)
     {
-        std::ifstream     shader_file(path);
-        std::stringstream shader_stream;
-        shader_stream << shader_file.rdbuf();
-        shader_file.close();
-        return shader_stream.str();
+        FileData data;
+        if (!g_context.m_vfs->read(path, data))
+        {
+            LOG_ERROR("Could not read shader source " + path);
+            return {};
+        }
+        return std::string(data.view());
+    }
+
+    /**
+     * @brief insert "#define NAME" lines right after the #version directive
+     *
+     * @param source glsl source
+     * @param defines macro names (optionally "NAME VALUE") selecting a shader variant
+     */
+    std::string Shader::injectDefines(const std::string& source, const std::vector<std::string>& defines)
+    {
+        if (defines.empty())
+            return source;
+
+        std::string block;
+        for (const auto& define : defines)
+            block += "#define " + define + "\n";
+
+        // #version must stay the first directive
+        size_t insert_pos = 0;
+        size_t version    = source.find("#version");
+        if (version != std::string::npos)
+        {
+            size_t line_end = source.find('\n', version);
+            insert_pos      = line_end == std::string::npos ? source.size() : line_end + 1;
+        }
+
+        std::string result = source;
+        if (insert_pos == result.size() && !result.empty() && result.back() != '\n')
+            result += '\n';
+        result.insert(std::min(insert_pos, result.size()), block);
+        return result;
     }
 
-    int Shader::getUniformLocation(const std::string& name)
+    int Shader::getUniformLocation(std::string_view name)
     {
         auto it = m_uniform_cache.find(name);
         if (it != m_uniform_cache.end())
             return it->second;
 
-        int location          = glGetUniformLocation(m_program, name.c_str());
-        m_uniform_cache[name] = location;
+        // first lookup only, gl needs a null-terminated name
+        std::string name_str(name);
+        int         location = glGetUniformLocation(m_program, name_str.c_str());
+        m_uniform_cache.emplace(std::move(name_str), location);
         return location;
     }
 } // namespace RealmEngine
\ No newline at end of file
@@ -3,36 +3,44 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <functional>
 #include <map>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace RealmEngine
 {
     class Shader
     {
     public:
-        Shader(const std::string& vertexPath, const std::string& fragmentPath);
+        Shader(const std::string&              vertexPath,
+               const std::string&              fragmentPath,
+               const std::vector<std::string>& defines = {});
         ~Shader();
 
         void         use() const;
         unsigned int getShaderProgram() const;
 
-        void setBool(const std::string& name, bool value);
-        void setInt(const std::string& name, int value);
-        void setFloat(const std::string& name, float value);
-        void setVec2(const std::string& name, const glm::vec2& value);
-        void setVec3(const std::string& name, const glm::vec3& value);
-        void setVec4(const std::string& name, const glm::vec4& value);
-        void setMat2(const std::string& name, const glm::mat2& mat);
-        void setMat3(const std::string& name, const glm::mat3& mat);
-        void setMat4(const std::string& name, const glm::mat4& mat);
+        void setBool(std::string_view name, bool value);
+        void setInt(std::string_view name, int value);
+        void setFloat(std::string_view name, float value);
+        void setVec2(std::string_view name, const glm::vec2& value);
+        void setVec3(std::string_view name, const glm::vec3& value);
+        void setVec4(std::string_view name, const glm::vec4& value);
+        void setMat2(std::string_view name, const glm::mat2& mat);
+        void setMat3(std::string_view name, const glm::mat3& mat);
+        void setMat4(std::string_view name, const glm::mat4& mat);
+
+        // -1 if the uniform does not exist or was optimized out
+        int getUniformLocation(std::string_view name);
 
     private:
         unsigned int               m_program {0};
-        std::map<std::string, int> m_uniform_cache;
+        std::map<std::string, int, std::less<>> m_uniform_cache; // string_view lookups, no temporaries
 
         static void        checkCompileErrors(unsigned int shader, const std::string& type);
         static std::string loadShaderSource(const std::string& path);
-        int                getUniformLocation(const std::string& name);
+        static std::string injectDefines(const std::string& source, const std::vector<std::string>& defines);
     };
 } // namespace RealmEngine
\ No newline at end of file
@@ -0,0 +1,207 @@
+#include "vfs.h"
+
+#include "global.h"
+
+#include <filesystem>
+#include <system_error>
+
+namespace RealmEngine
+{
+    namespace
+    {
+        bool statDisk(const std::string& path, FileInfo& info)
+        {
+            std::error_code ec;
+            if (!std::filesystem::is_regular_file(path, ec))
+                return false;
+
+            info.size = std::filesystem::file_size(path, ec);
+            if (ec)
+                return false;
+
+            auto write_time = std::filesystem::last_write_time(path, ec);
+            if (ec)
+                return false;
+
+            info.write_time = static_cast<int64_t>(write_time.time_since_epoch().count());
+            return true;
+        }
+
+        bool readDisk(const std::string& path, FileData& data)
+        {
+            auto file = std::make_shared<MappedFile>();
+            if (!file->open(path))
+                return false;
+
+            size_t size = file->size();
+            data        = FileData(std::move(file), 0, size);
+            return true;
+        }
+    } // namespace
+
+    void VirtualFileSystem::initialize()
+    {
+        mount("shader", "../shader");
+        mount("assets", "../assets");
+
+        // a packed build shadows the loose files, repack or remove it after editing assets
+        std::error_code ec;
+        if (std::filesystem::exists("../assets.pak", ec))
+            mount("assets", "../assets.pak");
+
+        LOG_INFO("Virtual File System initialized");
+    }
+
+    void VirtualFileSystem::terminate()
+    {
+        unmountAll();
+
+        LOG_INFO("Virtual File System terminated");
+    }
+
+    bool VirtualFileSystem::mount(const std::string& mount_point, const std::string& source)
+    {
+        Mount mount;
+        mount.mount_point = normalizePath(mount_point);
+
+        std::error_code ec;
+        if (std::filesystem::is_directory(source, ec))
+        {
+            mount.directory = source;
+        }
+        else
+        {
+            mount.archive = std::make_unique<PackArchive>();
+            if (!mount.archive->open(source))
+            {
+                LOG_ERROR("Could not mount " + source + " at /" + mount.mount_point);
+                return false;
+            }
+            LOG_INFO("Mounted archive " + source + " (" + std::to_string(mount.archive->getEntryCount()) +
+                     " files) at /" + mount.mount_point);
+        }
+
+        m_mounts.push_back(std::move(mount));
+        return true;
+    }
+
+    void VirtualFileSystem::unmountAll() { m_mounts.clear(); }
+
+    bool VirtualFileSystem::getRelativePath(const Mount& mount, const std::string& path, std::string& relative)
+    {
+        const std::string& point = mount.mount_point;
+        if (point.empty())
+        {
+            relative = path;
+            return true;
+        }
+
+        if (path.compare(0, point.size(), point) != 0)
+            return false;
+        if (path.size() == point.size())
+        {
+            relative.clear();
+            return true;
+        }
+        if (path[point.size()] != '/')
+            return false;
+
+        relative = path.substr(point.size() + 1);
+        return true;
+    }
+
+    bool VirtualFileSystem::read(const std::string& path, FileData& data) const
+    {
+        std::string normalized = normalizePath(path);
+        std::string relative;
+        for (auto it = m_mounts.rbegin(); it != m_mounts.rend(); ++it)
+        {
+            if (!getRelativePath(*it, normalized, relative))
+                continue;
+
+            if (it->archive ? it->archive->read(relative, data) : readDisk(it->directory + "/" + relative, data))
+                return true;
+        }
+
+        return readDisk(path, data);
+    }
+
+    bool VirtualFileSystem::stat(const std::string& path, FileInfo& info) const
+    {
+        std::string normalized = normalizePath(path);
+        std::string relative;
+        for (auto it = m_mounts.rbegin(); it != m_mounts.rend(); ++it)
+        {
+            if (!getRelativePath(*it, normalized, relative))
+                continue;
+
+            if (it->archive ? it->archive->stat(relative, info) : statDisk(it->directory + "/" + relative, info))
+                return true;
+        }
+
+        return statDisk(path, info);
+    }
+
+    bool VirtualFileSystem::exists(const std::string& path) const
+    {
+        FileInfo info;
+        return stat(path, info);
+    }
+
+    std::string VirtualFileSystem::resolveWritePath(const std::string& path) const
+    {
+        std::string normalized = normalizePath(path);
+        std::string relative;
+        for (auto it = m_mounts.rbegin(); it != m_mounts.rend(); ++it)
+        {
+            if (!it->archive && getRelativePath(*it, normalized, relative))
+                return it->directory + "/" + relative;
+        }
+
+        for (const Mount& mount : m_mounts)
+        {
+            if (getRelativePath(mount, normalized, relative))
+                return {};
+        }
+        return path;
+    }
+
+    std::string VirtualFileSystem::normalizePath(const std::string& path)
+    {
+        std::vector<std::string> segments;
+        std::string              segment;
+
+        auto flush = [&]() {
+            if (segment == "..")
+            {
+                if (!segments.empty() && segments.back() != "..")
+                    segments.pop_back();
+                else
+                    segments.push_back(segment);
+            }
+            else if (!segment.empty() && segment != ".")
+            {
+                segments.push_back(segment);
+            }
+            segment.clear();
+        };
+
+        for (char c : path)
+        {
+            if (c == '/' || c == '\\')
+                flush();
+            else
+                segment += c;
+        }
+        flush();
+
+        std::string result;
+        for (const std::string& s : segments)
+        {
+            if (!result.empty())
+                result += '/';
+            result += s;
+        }
+        return result;
+    }
+} // namespace RealmEngine
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "resource/mapped_file.h"
+#include "resource/pack_archive.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace RealmEngine
+{
+    /**
+     * @brief virtual file system, maps engine paths like "assets/model/x.obj" onto directories and .pak archives
+     *
+     * A path belongs to every mount whose mount point is a prefix of it. Mounts are searched newest first
+     * and the first one holding the file wins, so a mounted archive can sit on top of the loose directory
+     * and still fall through to it for files it lacks. Paths outside every mount are read from disk as is.
+     * Mount during startup only, reads are thread-safe once mounting is done.
+     */
+    class VirtualFileSystem
+    {
+    public:
+        void initialize();
+        void terminate();
+
+        // source is a directory or a .pak built by PackArchive::packDirectory
+        bool mount(const std::string& mount_point, const std::string& source);
+        void unmountAll();
+
+        bool read(const std::string& path, FileData& data) const;
+        bool exists(const std::string& path) const;
+        bool stat(const std::string& path, FileInfo& info) const;
+
+        // disk path a file at path would be written to, empty if it only maps into archives
+        std::string resolveWritePath(const std::string& path) const;
+
+        // forward slashes, no "." or empty segments, ".." folded where possible
+        static std::string normalizePath(const std::string& path);
+
+    private:
+        struct Mount
+        {
+            std::string                  mount_point; // normalized, empty mounts the root
+            std::string                  directory;
+            std::unique_ptr<PackArchive> archive;
+        };
+
+        // path relative to the mount point, false if mount does not cover path
+        static bool getRelativePath(const Mount& mount, const std::string& path, std::string& relative);
+
+        std::vector<Mount> m_mounts;
+    };
+} // namespace RealmEngine
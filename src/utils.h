@@ -1 +1,74 @@
-#pragma once
\ No newline at end of file
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace RealmEngine
+{
+    /**
+     * @brief stable LSD radix sort of 64-bit keys with a 32-bit payload (ascending)
+     *
+     * Sorts 8 bits per pass, all histograms are built in one sweep and passes where every key
+     * shares the same digit are skipped. Scratch buffers are passed in so callers can keep
+     * them alive across frames.
+     *
+     * @param keys sort keys, sorted in place
+     * @param values payload moved along with its key
+     * @param key_scratch scratch storage, resized as needed
+     * @param value_scratch scratch storage, resized as needed
+     */
+    inline void radixSort(std::vector<uint64_t>& keys,
+                          std::vector<uint32_t>& values,
+                          std::vector<uint64_t>& key_scratch,
+                          std::vector<uint32_t>& value_scratch)
+    {
+        constexpr int RADIX_BITS = 8;
+        constexpr int PASSES     = 64 / RADIX_BITS;
+        constexpr int BUCKETS    = 1 << RADIX_BITS;
+
+        const size_t count = keys.size();
+        if (count < 2)
+            return;
+
+        key_scratch.resize(count);
+        value_scratch.resize(count);
+
+        std::array<std::array<uint32_t, BUCKETS>, PASSES> histograms {};
+        for (uint64_t key : keys)
+        {
+            for (int pass = 0; pass < PASSES; ++pass)
+                ++histograms[pass][(key >> (pass * RADIX_BITS)) & (BUCKETS - 1)];
+        }
+
+        for (int pass = 0; pass < PASSES; ++pass)
+        {
+            auto& histogram = histograms[pass];
+
+            // every key has the same digit here, order would not change
+            const int shift = pass * RADIX_BITS;
+            if (histogram[(keys[0] >> shift) & (BUCKETS - 1)] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (auto& bucket : histogram)
+            {
+                uint32_t bucket_count = bucket;
+                bucket                = offset;
+                offset += bucket_count;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+            {
+                uint32_t dst       = histogram[(keys[i] >> shift) & (BUCKETS - 1)]++;
+                key_scratch[dst]   = keys[i];
+                value_scratch[dst] = values[i];
+            }
+
+            std::swap(keys, key_scratch);
+            std::swap(values, value_scratch);
+        }
+    }
+} // namespace RealmEngine